@@ -1,10 +1,10 @@
 set(PLUGIN_NAME csjson)
 
 # Dependencies
-    # None
+find_package(Threads REQUIRED)
 
 # Source files
 set(CPPFILES src/opcodes.cpp)
 set(INCLUDES ${CSOUND_INCLUDE_DIRS} "include")
-make_plugin(${PLUGIN_NAME} "${CPPFILES}")
+make_plugin(${PLUGIN_NAME} "${CPPFILES}" ${CMAKE_THREAD_LIBS_INIT})
 target_include_directories(${PLUGIN_NAME} PRIVATE ${INCLUDES})
@@ -0,0 +1,136 @@
+/*
+    filemapping.h
+    Copyright (C) 2022 Richard Knight
+
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program; if not, write to the Free Software Foundation,
+    Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+ */
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <stddef.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define FILEMAPPING_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Read only view of the contents of a file. The file is memory mapped where
+ * the platform allows, so the contents are paged in by the OS as they are read
+ * rather than being copied into a buffer first. Elsewhere, or if the file
+ * cannot be mapped, the contents are read into memory in one go.
+ */
+class MappedFile {
+public:
+    MappedFile(const char* path) : contents(nullptr), length(0), mapped(false) {
+#if defined(_WIN32)
+        file = CreateFileA(
+            path, GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL
+        );
+        mapping = NULL;
+        if (file != INVALID_HANDLE_VALUE) {
+            LARGE_INTEGER fileSize;
+            if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+                mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+                if (mapping != NULL) {
+                    contents = (const char*) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    if (contents != nullptr) {
+                        length = (size_t) fileSize.QuadPart;
+                        mapped = true;
+                        return;
+                    }
+                }
+            }
+        }
+#elif defined(FILEMAPPING_POSIX)
+        int fd = open(path, O_RDONLY);
+        if (fd >= 0) {
+            struct stat status;
+            if (fstat(fd, &status) == 0 && status.st_size > 0) {
+                void* address = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+                    madvise(address, (size_t) status.st_size, MADV_SEQUENTIAL);
+#endif
+                    contents = (const char*) address;
+                    length = (size_t) status.st_size;
+                    mapped = true;
+                }
+            }
+            close(fd); // the mapping holds its own reference to the file
+            if (mapped) return;
+        }
+#endif
+        std::ifstream fileStream(path, std::ios::in | std::ios::binary);
+        if (!fileStream.is_open()) {
+            release();
+            throw std::runtime_error("could not open file for reading");
+        }
+        fileStream.seekg(0, std::ios::end);
+        buffer.resize((size_t) fileStream.tellg());
+        fileStream.seekg(0, std::ios::beg);
+        fileStream.read(&buffer[0], buffer.size());
+        contents = buffer.data();
+        length = buffer.size();
+    }
+
+    ~MappedFile() {
+        release();
+    }
+
+    const char* data() const {
+        return contents;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    void release() {
+#if defined(_WIN32)
+        if (mapped) UnmapViewOfFile(contents);
+        if (mapping != NULL) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#elif defined(FILEMAPPING_POSIX)
+        if (mapped) munmap((void*) contents, length);
+#endif
+        mapped = false;
+    }
+
+    const char* contents;
+    size_t length;
+    bool mapped;
+    std::string buffer;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
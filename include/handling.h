@@ -19,44 +19,194 @@
  
  */
 #include <plugin.h>
+#include <vector>
+#include <deque>
+#include <stdexcept>
+#include <stdint.h>
+
+/*
+ * Slab-backed registry of handle objects. Slots are allocated in fixed size
+ * slabs so that object pointers remain stable, and freed slots are kept on a
+ * free list for reuse. Each slot carries a generation which is encoded in the
+ * upper bits of the handle so that a recycled slot is not mistaken for the
+ * object that previously occupied it. Freed slots are reused oldest first, so
+ * a slot is only reused once all others freed before it have been, delaying
+ * the point at which its generation wraps. Creation, lookup and destruction
+ * are O(1).
+ */
+template <typename T>
+class HandleRegistry {
+public:
+    static const uint32_t slabSize = 4096;
+
+    // handles must be represented exactly by MYFLT, so a float build splits its
+    // 24 bits of precision between the slot index and generation
+    static const bool exactDouble = sizeof(MYFLT) >= sizeof(double);
+    static const uint32_t indexBits = exactDouble ? 24 : 16;
+    static const uint32_t maxSlots = 1 << indexBits;
+    static const uint32_t generationBits = exactDouble ? 28 : 8;
+    static const uint32_t generationMask = (1 << generationBits) - 1;
+
+    HandleRegistry() : slotCount(0) {}
+
+    ~HandleRegistry() {
+        for (std::size_t i = 0; i < slabs.size(); i++) {
+            delete[] slabs[i];
+        }
+    }
+
+    /*
+     * Obtain a free slot, returning the object and setting the handle
+     */
+    T* create(MYFLT* handle) {
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.front();
+            freeSlots.pop_front();
+        } else {
+            if (slotCount >= maxSlots) {
+                return NULL;
+            }
+            if (slotCount % slabSize == 0) {
+                slabs.push_back(new Slot[slabSize]);
+            }
+            index = slotCount++;
+        }
+        Slot* slot = getSlot(index);
+        slot->used = true;
+        *handle = (MYFLT) (((uint64_t) slot->generation << indexBits) | index);
+        return &slot->item;
+    }
+
+    /*
+     * Get the object for a handle, or NULL if the handle is invalid or stale
+     */
+    T* get(MYFLT handle) {
+        Slot* slot = lookup(handle);
+        return (slot == NULL) ? NULL : &slot->item;
+    }
+
+    /*
+     * Check if a handle refers to a slot that has since been destroyed or reused
+     */
+    bool isStale(MYFLT handle) {
+        if (handle < 0 || handle != (MYFLT) (uint64_t) handle) {
+            return false;
+        }
+        uint32_t index = (uint32_t) ((uint64_t) handle & (maxSlots - 1));
+        return index < slotCount && lookup(handle) == NULL;
+    }
+
+    /*
+     * Reset the object for a handle and return the slot to the free list
+     */
+    bool destroy(MYFLT handle) {
+        Slot* slot = lookup(handle);
+        if (slot == NULL) {
+            return false;
+        }
+        slot->item = T();
+        slot->used = false;
+        slot->generation = (slot->generation + 1) & generationMask;
+        freeSlots.push_back((uint32_t) ((uint64_t) handle & (maxSlots - 1)));
+        return true;
+    }
+
+    /*
+     * Number of handles currently in use
+     */
+    std::size_t size() const {
+        return slotCount - freeSlots.size();
+    }
+
+private:
+    struct Slot {
+        T item;
+        uint32_t generation;
+        bool used;
+        Slot() : item(), generation(0), used(false) {}
+    };
+
+    std::vector<Slot*> slabs;
+    std::deque<uint32_t> freeSlots;
+    uint32_t slotCount;
+
+    Slot* getSlot(uint32_t index) {
+        return &slabs[index / slabSize][index % slabSize];
+    }
+
+    Slot* lookup(MYFLT handle) {
+        if (handle < 0 || handle != (MYFLT) (uint64_t) handle) {
+            return NULL;
+        }
+        uint64_t value = (uint64_t) handle;
+        uint32_t index = (uint32_t) (value & (maxSlots - 1));
+        uint32_t generation = (uint32_t) (value >> indexBits);
+        if (index >= slotCount || generation > generationMask) {
+            return NULL;
+        }
+        Slot* slot = getSlot(index);
+        if (!slot->used || slot->generation != generation) {
+            return NULL;
+        }
+        return slot;
+    }
+};
+
+
+/*
+ * Reset callback to free a registry when Csound is reset
+ */
+template <typename T>
+int destroyRegistry(CSOUND* csound, void* data) {
+    delete (HandleRegistry<T>*) data;
+    return OK;
+}
+
+
+/*
+ * Obtain the registry stored in global variables by name, creating it if required
+ */
+template <typename T>
+HandleRegistry<T>* getRegistry(csnd::Csound* csound, const char* name) {
+    HandleRegistry<T>** registry = (HandleRegistry<T>**) csound->query_global_variable(name);
+    if (registry == NULL) {
+        csound->create_global_variable(name, sizeof(HandleRegistry<T>*));
+        registry = (HandleRegistry<T>**) csound->query_global_variable(name);
+        *registry = new HandleRegistry<T>();
+        csound->get_csound()->RegisterResetCallback(
+            csound->get_csound(), (void*) *registry, destroyRegistry<T>
+        );
+    }
+    return *registry;
+}
 
-const char* handleIdentifier = "::%s%d";
 
 /*
- * Obtain global object of typename from global variables by handle
+ * Obtain global object of typename from registry by handle
  */
 template <typename T>
 T* getHandle(csnd::Csound* csound, MYFLT handle, const char* name) {
-    char buffer[32];
-    snprintf(buffer, 32, handleIdentifier, name, (int)handle);
-    return (T*) csound->query_global_variable(buffer);  
+    return getRegistry<T>(csound, name)->get(handle);
 }
 
 
 /*
- * Create global object of typename in global variables, returning handle
+ * Create global object of typename in registry, returning handle
  */
 template <typename T>
 MYFLT createHandle(csnd::Csound* csound, T** data, const char* name) {
-    char buffer[32];
-    int handle = 0;
-    snprintf(buffer, 32, handleIdentifier, name, handle);
-    while ((*data = (T*) csound->query_global_variable(buffer)) != NULL) {
-        snprintf(buffer, 32, handleIdentifier, name, ++handle);
-    }
-    csound->create_global_variable(buffer, sizeof(T));
-    *data = (T*) csound->query_global_variable(buffer);
-    
-    return FL(handle);
+    MYFLT handle;
+    if ((*data = getRegistry<T>(csound, name)->create(&handle)) == NULL) {
+        throw std::runtime_error("cannot create handle: maximum number of handles reached");
+    }
+    return handle;
 }
 
 /*
  * Destroy global object
  */
+template <typename T>
 void destroyHandle(csnd::Csound* csound, MYFLT handle, const char* name) {
-    char buffer[32];
-    snprintf(buffer, 32, handleIdentifier, name, (int)handle);
-    csound->destroy_global_variable(buffer);
+    getRegistry<T>(csound, name)->destroy(handle);
 }
-
-
@@ -0,0 +1,87 @@
+/*
+    lrucache.h
+    Copyright (C) 2022 Richard Knight
+
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program; if not, write to the Free Software Foundation,
+    Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+ */
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <stdint.h>
+
+/*
+ * Thread safe least recently used cache of shared values keyed by string.
+ * Values are shared so that an evicted value remains valid for any holder.
+ */
+template <typename T>
+class LRUCache {
+public:
+    LRUCache(std::size_t capacity) : capacity(capacity), hits(0), misses(0) {}
+
+    /*
+     * Get the value for a key, creating it with create(key) if not cached
+     */
+    template <typename F>
+    std::shared_ptr<T> get(const std::string& key, F create) {
+        std::lock_guard<std::mutex> lock(mutex);
+        typename Index::iterator found = index.find(key);
+        if (found != index.end()) {
+            hits++;
+            entries.splice(entries.begin(), entries, found->second);
+            return found->second->second;
+        }
+        misses++;
+        std::shared_ptr<T> value = std::make_shared<T>(create(key));
+        entries.push_front(Entry(key, value));
+        index[key] = entries.begin();
+        if (entries.size() > capacity) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        return value;
+    }
+
+    uint64_t getHits() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hits;
+    }
+
+    uint64_t getMisses() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return misses;
+    }
+
+    std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+private:
+    typedef std::pair<std::string, std::shared_ptr<T>> Entry;
+    typedef std::unordered_map<std::string, typename std::list<Entry>::iterator> Index;
+
+    std::size_t capacity;
+    uint64_t hits;
+    uint64_t misses;
+    std::list<Entry> entries;
+    Index index;
+    std::mutex mutex;
+};
+
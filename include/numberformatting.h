@@ -0,0 +1,226 @@
+/*
+    numberformatting.h
+    Copyright (C) 2022 Richard Knight
+
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program; if not, write to the Free Software Foundation,
+    Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace numberformatting {
+
+// space required for any output of formatDouble
+static const size_t bufferSize = 400;
+
+// largest precision handled without falling back to snprintf
+static const int maximumFastPrecision = 15;
+
+static const double powersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/*
+ * Multiply by an exact power of ten between 10^-22 and 10^22, so the result has
+ * a single rounding error
+ */
+inline double scale(double value, int exponent) {
+    return (exponent < 0) ? value / powersOfTen[-exponent] : value * powersOfTen[exponent];
+}
+
+/*
+ * Round a non negative scaled value to an integer, half to even. Returns false
+ * if the value is close enough to half way that the rounding error of scaling
+ * could change the result, or too large for the fraction to be known
+ */
+inline bool roundScaled(double scaled, uint64_t& rounded) {
+    if (!(scaled < 4503599627370496.0)) return false; // 2^52
+    double whole = std::floor(scaled);
+    double fraction = scaled - whole;
+    double margin = std::ldexp(1.0, std::ilogb(scaled < 1 ? 1.0 : scaled) - 50);
+    if (std::fabs(fraction - 0.5) <= margin) return false;
+    rounded = (uint64_t) whole + ((fraction > 0.5) ? 1 : 0);
+    return true;
+}
+
+/*
+ * Write the decimal digits of a value, padded with zeros to a minimum count,
+ * returning the number written
+ */
+inline size_t writeDigits(uint64_t value, size_t minimum, char* output) {
+    char digits[24];
+    size_t count = 0;
+    do {
+        digits[count++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (count < minimum) {
+        digits[count++] = '0';
+    }
+    for (size_t i = 0; i < count; i++) {
+        output[i] = digits[count - 1 - i];
+    }
+    return count;
+}
+
+/*
+ * Format with snprintf, with the decimal point normalised regardless of locale
+ * and ".0" added to results which would otherwise read as integers
+ */
+inline size_t formatPrintf(double value, int precision, bool fixed, char* output) {
+    int length = snprintf(output, bufferSize - 2, (fixed) ? "%1.*f" : "%1.*g", precision, value);
+    if (length < 0) {
+        length = 0;
+    } else if (length > (int) bufferSize - 3) {
+        length = (int) bufferSize - 3;
+    }
+    bool needsPoint = true;
+    for (int i = 0; i < length; i++) {
+        char c = output[i];
+        if (c == 'e' || c == 'E') {
+            output[i] = 'e';
+            needsPoint = false;
+        } else if (c != '-' && c != '+' && (c < '0' || c > '9')) {
+            output[i] = '.';
+            needsPoint = false;
+        }
+    }
+    if (needsPoint) {
+        output[length++] = '.';
+        output[length++] = '0';
+    }
+    return (size_t) length;
+}
+
+/*
+ * Format a finite value with a number of digits after the decimal point
+ */
+inline size_t formatFixed(double value, int precision, char* output) {
+    uint64_t rounded;
+    if (precision > maximumFastPrecision || !roundScaled(scale(std::fabs(value), precision), rounded)) {
+        return formatPrintf(value, precision, true, output);
+    }
+    size_t length = 0;
+    if (std::signbit(value)) output[length++] = '-';
+    uint64_t divisor = (uint64_t) powersOfTen[precision];
+    length += writeDigits(rounded / divisor, 1, output + length);
+    output[length++] = '.';
+    length += writeDigits(rounded % divisor, precision, output + length);
+    return length;
+}
+
+/*
+ * Format a finite value with a number of significant digits, as printf %g:
+ * exponent notation for small and large values and no trailing zeros
+ */
+inline size_t formatGeneral(double value, int precision, char* output) {
+    double magnitude = std::fabs(value);
+    if (precision > maximumFastPrecision || magnitude == 0) {
+        return formatPrintf(value, precision, false, output);
+    }
+    
+    // find the exponent for which rounding gives exactly precision digits
+    int exponent = (int) std::floor(std::log10(magnitude));
+    uint64_t rounded = 0;
+    uint64_t lower = (uint64_t) powersOfTen[precision - 1];
+    uint64_t upper = (uint64_t) powersOfTen[precision];
+    bool found = false;
+    for (int attempt = 0; attempt < 2 && !found; attempt++) {
+        int shift = precision - 1 - exponent;
+        if (shift < -22 || shift > 22 || !roundScaled(scale(magnitude, shift), rounded)) {
+            return formatPrintf(value, precision, false, output);
+        }
+        if (rounded >= upper) {
+            if (rounded == upper) {
+                rounded = lower;
+                exponent++;
+                found = true;
+            } else {
+                exponent++;
+            }
+        } else if (rounded < lower) {
+            exponent--;
+        } else {
+            found = true;
+        }
+    }
+    if (!found) {
+        return formatPrintf(value, precision, false, output);
+    }
+    
+    char digits[24];
+    size_t count = writeDigits(rounded, precision, digits);
+    while (count > 1 && digits[count - 1] == '0') {
+        count--;
+    }
+    size_t length = 0;
+    if (std::signbit(value)) output[length++] = '-';
+    
+    if (exponent < -4 || exponent >= precision) {
+        output[length++] = digits[0];
+        if (count > 1) {
+            output[length++] = '.';
+            memcpy(output + length, digits + 1, count - 1);
+            length += count - 1;
+        }
+        output[length++] = 'e';
+        output[length++] = (exponent < 0) ? '-' : '+';
+        length += writeDigits((uint64_t) std::abs(exponent), 2, output + length);
+    } else if (exponent >= 0) {
+        size_t whole = (size_t) exponent + 1;
+        if (count <= whole) {
+            memcpy(output + length, digits, count);
+            length += count;
+            for (size_t i = count; i < whole; i++) {
+                output[length++] = '0';
+            }
+            output[length++] = '.';
+            output[length++] = '0';
+        } else {
+            memcpy(output + length, digits, whole);
+            length += whole;
+            output[length++] = '.';
+            memcpy(output + length, digits + whole, count - whole);
+            length += count - whole;
+        }
+    } else {
+        output[length++] = '0';
+        output[length++] = '.';
+        for (int i = -1; i > exponent; i--) {
+            output[length++] = '0';
+        }
+        memcpy(output + length, digits, count);
+        length += count;
+    }
+    return length;
+}
+
+/*
+ * Format a finite value to the given precision, as fixed with that number of
+ * decimal places or general with that number of significant digits. The
+ * output is the same as printf %f or %g with the decimal point normalised and
+ * ".0" added to integers, but avoids printf where the correctly rounded digits
+ * can be found with double arithmetic. Output is not terminated
+ */
+inline size_t formatDouble(double value, int precision, bool fixed, char* output) {
+    return (fixed) ? formatFixed(value, precision, output) : formatGeneral(value, precision, output);
+}
+
+}
@@ -19,1126 +19,3997 @@
  
  */
 #include <jsoncons/json.hpp>
+#include <jsoncons/json_cursor.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/csv/csv.hpp>
 #include <jsoncons_ext/jsonpath/jsonpath.hpp>
 #include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
 #include <iostream>
 #include <fstream>
 #include <exception>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <plugin.h>
 #include "handling.h"
+#include "lrucache.h"
+#include "filemapping.h"
+#include "numberformatting.h"
+#include "numberparsing.h"
 
 #define ARGT static constexpr char const
 
+// number of compiled JSONPath expressions kept in each cache
+#define PATHCACHESIZE 256
+
+// bytes parsed between cancellation checks when loading in the background
+#define ASYNCCHUNKSIZE 65536
+
+// bytes parsed between time checks when parsing incrementally
+#define INCREMENTALCHUNKSIZE 4096
+
+// number of JSON Lines records parsed ahead of being requested
+#define LINESREADAHEAD 64
+
+// size of the file buffer used when reading JSON Lines
+#define LINESBUFFERSIZE 65536
+
 
 const char* badHandle = "cannot obtain data from handle";
 const char* deadHandle = "object has been destroyed";
-const char* handleName = "jsonsession";
+const char* notArray = "object is not an array";
+const char* notObject = "object is not a key/value object";
+const char* loadingHandle = "object is still loading";
+const char* staleView = "view is no longer valid as the parent object has been modified or destroyed";
+const char* handleName = "::jsonsession";
+const char* linesHandleName = "::jsonlinessession";
+const char* writeQueueName = "::jsonwritequeue";
+
+/*
+ Process-wide unique modification version, so a version is never repeated
+ when a session handle is reused after being destroyed
+ */
+static uint64_t nextVersion() {
+    static std::atomic<uint64_t> counter(0);
+    return ++counter;
+}
 
 struct JSONSession {
-    jsoncons::json data;
-    bool active;
+    static const int sorted = 0;
+    static const int hashed = 1;
+    
+    std::shared_ptr<jsoncons::json> document; // owned data, empty object if null, shared with snapshots
+    const jsoncons::json* view; // subtree of a parent object when not owning data
+    MYFLT viewParent;
+    uint64_t viewParentVersion;
+    uint64_t version; // changed on each modification
+    uint64_t structureVersion; // changed on each modification other than in place scalar assignment
+    bool local; // destroyed when the creating instrument instance ends
+    const void* owner; // opcode instance which destroys the object if local
+    bool pending; // data is still being loaded in the background
+    double loadTime; // seconds taken to load from file
+    size_t loadBytes; // size of the file loaded
+    int storage; // how members inserted by key are held, sorted or hashed
+    std::unordered_map<std::string, jsoncons::json> staged; // hashed members not yet merged into data
+    
+    JSONSession() : view(nullptr), viewParent(-1), viewParentVersion(0), version(nextVersion()), structureVersion(version),
+        local(false), owner(nullptr), pending(false), loadTime(0), loadBytes(0), storage(sorted) {}
+    
+    /*
+     Get the data for reading, which is the parent subtree if a view. Staged
+     members are not included, so materialise() must have been called first
+     */
+    const jsoncons::json& read() const {
+        if (view != nullptr) return *view;
+        return (document == nullptr) ? emptyObject() : *document;
+    }
+    
+    /*
+     Replace the data, ending any view. Snapshots of the previous data are
+     unaffected
+     */
+    void assign(jsoncons::json value) {
+        document = std::make_shared<jsoncons::json>(std::move(value));
+        view = nullptr;
+        staged.clear();
+        modified();
+    }
+    
+    /*
+     Get a reference counted snapshot of the data for reading on another
+     thread. Nothing is copied here: the next modification copies the data
+     instead if the snapshot is still held. A view shares the data of its
+     parent session, which must be given. Staged members are not included, so
+     materialise() must have been called first
+     */
+    std::shared_ptr<const jsoncons::json> snapshot(const JSONSession* parent) const {
+        return std::shared_ptr<const jsoncons::json>((view == nullptr) ? document : parent->document, &read());
+    }
+    
+    /*
+     Move staged members into the object so that read() gives the whole
+     object. As this reorders the member list, the version is changed so that
+     locations resolved beforehand are not reused
+     */
+    void materialise() {
+        if (staged.empty()) return;
+        merge();
+        modified();
+    }
+    
+    /*
+     Get the data for modification, copying the parent subtree first if a view
+     */
+    jsoncons::json& write() {
+        if (view != nullptr) {
+            document = std::make_shared<jsoncons::json>(*view);
+            view = nullptr;
+        }
+        merge();
+        modified();
+        return own();
+    }
+    
+    /*
+     Insert or replace a member of an object. With hashed storage, new members
+     are held in a hash table until the whole object is next required, rather
+     than each being inserted into the sorted member list of the object
+     */
+    void insert(std::string&& key, jsoncons::json&& value) {
+        if (storage != hashed || view != nullptr || !read().is_object()) {
+            write().insert_or_assign(std::move(key), std::move(value));
+            return;
+        }
+        modified();
+        jsoncons::json& data = own();
+        jsoncons::json::object_iterator existing = data.find(key);
+        if (existing != data.object_range().end()) {
+            existing->value() = std::move(value);
+        } else {
+            staged[std::move(key)] = std::move(value);
+        }
+    }
+    
+    /*
+     Assign a new scalar value in place of an existing scalar value in the
+     data. The structure is unchanged, so locations resolved beforehand remain
+     valid, but views are invalidated as the content has changed. Returns false
+     without assigning if a snapshot shares the data, as the target must then
+     be located again in a copy
+     */
+    bool assignScalar(const jsoncons::json* target, const jsoncons::json& value) {
+        if (isShared()) return false;
+        *const_cast<jsoncons::json*>(target) = value;
+        version = nextVersion();
+        return true;
+    }
+    
+    /*
+     Get a member of an object, throwing if it does not exist
+     */
+    const jsoncons::json& member(const char* key) const {
+        if (!staged.empty()) {
+            std::unordered_map<std::string, jsoncons::json>::const_iterator found = staged.find(key);
+            if (found != staged.end()) {
+                return found->second;
+            }
+            const jsoncons::json& data = read();
+            jsoncons::json::const_object_iterator existing = data.find(key);
+            if (existing == data.object_range().end()) {
+                throw jsoncons::key_not_found(key, strlen(key));
+            }
+            return existing->value();
+        }
+        return read().at(key);
+    }
+    
+    /*
+     Number of members or items
+     */
+    std::size_t size() const {
+        return (staged.empty()) ? read().size() : read().size() + staged.size();
+    }
+    
+private:
+    static const jsoncons::json& emptyObject() {
+        static const jsoncons::json empty;
+        return empty;
+    }
+    
+    /*
+     Check if a snapshot still holds the data. When it does not, the fence
+     orders any reads made through the snapshot before the release of its
+     reference ahead of the modification that follows
+     */
+    bool isShared() const {
+        if (document.use_count() > 1) return true;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return false;
+    }
+    
+    /*
+     Get the owned data for modification, copying it first if a snapshot
+     shares it. Only the performance thread takes snapshots, so the data cannot
+     become shared again while it is modified
+     */
+    jsoncons::json& own() {
+        if (document == nullptr) {
+            document = std::make_shared<jsoncons::json>();
+        } else if (isShared()) {
+            document = std::make_shared<jsoncons::json>(*document);
+        }
+        return *document;
+    }
+    
+    /*
+     Mark the data as modified in a way that may move or remove values
+     */
+    void modified() {
+        version = structureVersion = nextVersion();
+    }
+    
+    /*
+     Move hashed members into the sorted member list of the object, sorting
+     them all at once
+     */
+    void merge() {
+        if (staged.empty()) return;
+        own().insert(std::make_move_iterator(staged.begin()), std::make_move_iterator(staged.end()));
+        staged.clear();
+    }
 };
 
+typedef jsoncons::jsonpath::jsonpath_expression<jsoncons::json> JSONPathQuery;
+typedef jsoncons::jsonpath::jsonpath_expression<jsoncons::json, jsoncons::json&> JSONPathReplace;
+
 /*
-    Initialise an array and return STRINDAT pointer in case it is required
+ Get the process-wide cache of compiled JSONPath expressions of a type
  */
-STRINGDAT* arrayInit(csnd::Csound* csound, ARRAYDAT* array, int rows, int cols) {
-    int totalResults = rows * cols;
-    size_t totalAllocated;
+template <typename T>
+LRUCache<T>& getPathCache() {
+    static LRUCache<T> cache(PATHCACHESIZE);
+    return cache;
+}
+
+
+/*
+ Get a compiled JSONPath expression from the cache, compiling it if required
+ */
+template <typename T>
+std::shared_ptr<T> compilePath(const std::string& path) {
+    return getPathCache<T>().get(path, [](const std::string& key) {
+        return T::compile(key);
+    });
+}
+
+
+/*
+ JSONPath expression held by an opcode, only recompiled when the path changes
+ */
+template <typename T>
+struct JSONPathHolder {
+    std::string path;
+    std::shared_ptr<T> expression;
     
-    //if (array->data == NULL) {
-        array->sizes = (int32_t*) csound->calloc(sizeof(int32_t) * 2);
-        array->sizes[0] = rows;
-        if (cols != 1) {
-            array->sizes[1] = cols;
+    T& get(const char* newPath) {
+        if (expression == nullptr || path != newPath) {
+            path.assign(newPath);
+            expression = compilePath<T>(path);
         }
-        array->dimensions = cols;
-        CS_VARIABLE *var = array->arrayType->createVariable(csound->get_csound(), NULL);
-        array->arrayMemberSize = var->memBlockSize;
-        totalAllocated = array->arrayMemberSize * totalResults;
-        array->data = (MYFLT*) csound->calloc(totalAllocated);
-    // } else
-    if ((totalAllocated = array->arrayMemberSize * totalResults) > array->allocated) {
-        array->data = (MYFLT*) csound->realloc(array->data, totalAllocated);
-        memset((char*)(array->data)+array->allocated, '\0', totalAllocated - array->allocated);
-        array->allocated = totalAllocated;
+        return *expression;
     }
+};
+
+
+/*
+ JSON Pointer held by an opcode, only parsed when the pointer string changes.
+ The resolved location is cached against the session handle and structure
+ version, so the document is only walked again after its structure has been
+ modified
+ */
+struct JSONPointerHolder {
+    std::string text;
+    jsoncons::jsonpointer::json_pointer pointer;
+    const jsoncons::json* resolved;
+    MYFLT handle;
+    uint64_t version;
+    bool isResolved;
     
-    // convenience return to be used if it is a string array
-    return (STRINGDAT*) array->data;
-}
+    JSONPointerHolder() : resolved(nullptr), handle(-1), version(0), isResolved(false) {}
+    
+    void parse(const char* newText) {
+        if (text != newText) {
+            pointer = jsoncons::jsonpointer::json_pointer(jsoncons::string_view(newText));
+            text.assign(newText);
+            isResolved = false;
+        }
+    }
+    
+    /*
+     Get the location in the session data, or nullptr if it does not exist
+     */
+    const jsoncons::json* find(JSONSession* session, MYFLT sessionHandle) {
+        if (!isResolved || handle != sessionHandle || version != session->structureVersion) {
+            std::error_code ec;
+            const jsoncons::json& found = jsoncons::jsonpointer::get(session->read(), pointer, ec);
+            resolved = (ec) ? nullptr : &found;
+            handle = sessionHandle;
+            version = session->structureVersion;
+            isResolved = true;
+        }
+        return resolved;
+    }
+    
+    /*
+     Get the location in the session data, throwing if it does not exist
+     */
+    const jsoncons::json& get(JSONSession* session, MYFLT sessionHandle) {
+        const jsoncons::json* found = find(session, sessionHandle);
+        if (found == nullptr) {
+            return jsoncons::jsonpointer::get(session->read(), pointer);
+        }
+        return *found;
+    }
+    
+    /*
+     Replace the value at the location. Existing scalar values are assigned in
+     place as the structure is unchanged, otherwise the document is modified
+     */
+    void replace(JSONSession* session, MYFLT sessionHandle, const jsoncons::json& value) {
+        if (session->view == nullptr) {
+            const jsoncons::json* target = find(session, sessionHandle);
+            if (target != nullptr && !target->is_array() && !target->is_object() && session->assignScalar(target, value)) {
+                return;
+            }
+        }
+        jsoncons::jsonpointer::replace(session->write(), pointer, value, true);
+    }
+};
 
 
 /*
- Insert a string to an array
+ Conversion of decimal number text to double, using the Eisel-Lemire fast path
+ where possible and the full precision jsoncons conversion for the rare cases
+ it cannot resolve
  */
-void insertArrayStringItem(csnd::Csound* csound, STRINGDAT* strings, int index, char* item) {
-    strings[index].size = strlen(item) + 1;
-    if (strings[index].data != NULL) {
-        csound->free(strings[index].data);
+class NumberConverter {
+public:
+    double operator()(const char* text, std::size_t length) {
+        double value;
+        if (numberparsing::parseDouble(text, length, value)) {
+            return value;
+        }
+        buffer.assign(text, length);
+        return toDouble(buffer.c_str(), buffer.size());
     }
-    strings[index].data = csound->strdup(item);
-}
+    
+private:
+    std::string buffer;
+    jsoncons::detail::chars_to toDouble;
+};
 
 
 /*
- Convert JSON array to Csound array either as string or numeric
+ Parse event filter which converts the number text passed on by a parser with
+ lossless_number set, so that numbers with fractions or exponents are
+ converted with NumberConverter rather than by the parser
  */
-void jsonArrayToCSArray(csnd::Csound* csound, jsoncons::json* jdatap, ARRAYDAT* array, bool asString) {
-    jsoncons::json jdata = *jdatap;
-    std::vector<std::string> vals = jdata.as<std::vector<std::string>>();
+class FastNumberFilter : public jsoncons::json_filter {
+public:
+    FastNumberFilter(jsoncons::json_visitor& destination) : jsoncons::json_filter(destination) {}
     
-    STRINGDAT* strings = arrayInit(csound, array, vals.size(), 1);
+    static const jsoncons::json_options& options() {
+        static const jsoncons::json_options lossless = jsoncons::json_options().lossless_number(true);
+        return lossless;
+    }
     
-    char* value;
-    for (std::size_t index = 0; index < vals.size(); index++) {
-        value = (char*) vals[index].c_str();
-        if (asString) {
-            insertArrayStringItem(csound, strings, index, value);
-        } else {
-            array->data[index] = (MYFLT) atof(value);
-        }        
+private:
+    bool visit_string(const string_view_type& value, jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        if (tag == jsoncons::semantic_tag::bigdec) {
+            return destination().double_value(convert(value.data(), value.size()), jsoncons::semantic_tag::none, context, ec);
+        }
+        return destination().string_value(value, tag, context, ec);
     }
-}
+    
+    NumberConverter convert;
+};
 
 
 /*
- Get the JSON type of a session object
+ Parse JSON text, optionally converting numbers with FastNumberFilter
  */
-int getJsonType(JSONSession* jsonSession) {
-    jsoncons::json j = jsonSession->data;
-    int outtype = -1;
-    if (j.is_null()) {
-        outtype = 0;
-    } else if (j.is_string()) {
-        outtype = 1;
-    } else if (j.is_number()) {
-        outtype = 2;
-    } else if (j.is_bool()) {
-        outtype = 3;
-    } else if (j.is_array()) {
-        outtype = 4;
-    } else if (j.is_object()) {
-        outtype = 5;
+jsoncons::json parseJson(jsoncons::string_view text, bool fastNumbers) {
+    if (!fastNumbers) {
+        return jsoncons::json::parse(text);
     }
-    return outtype;
+    jsoncons::json_decoder<jsoncons::json> decoder;
+    FastNumberFilter filter(decoder);
+    jsoncons::json_string_reader reader(text, filter, FastNumberFilter::options());
+    reader.read();
+    if (!decoder.is_valid()) {
+        throw std::runtime_error("invalid JSON");
+    }
+    return decoder.get_result();
 }
 
-// cs AppendOpcode mallocs struct so virtual functions cannot be used. 
-// Macro workaround to fake struct derivation type model, just chuck it all in a macro...
 
-#define _PLUGINSESSIONBASE(idInArgs)\
-    JSONSession* jsonSession;\
-    JSONSession* jsonDeinitSession;\
-    MYFLT handleDeinit;\
-    int deinit() {\
-        if (jsonDeinitSession != nullptr && jsonDeinitSession->active) {\
-            jsonSession->data.~basic_json();\
-            jsonSession->active = false;\
-        }\
-        if (handleDeinit != -1) {\
-            destroyHandle(csound, handleDeinit, handleName);\
-        }\
-        return OK;\
-    }\
-    void registerDeinit(JSONSession* jsonDeinitSession, MYFLT handleDeinit) {\
-        this->jsonDeinitSession = jsonDeinitSession;\
-        this->handleDeinit = handleDeinit;\
-        csound->plugin_deinit(this);\
-    }\
-    void getSession() {\
-        if (!(jsonSession = getHandle<JSONSession>(csound, idInArgs[0], handleName))) {\
-			throw std::runtime_error(badHandle);\
-		}\
-        if (!jsonSession->active) throw std::runtime_error(deadHandle);\
-    }\
-	void getSession(MYFLT handle, JSONSession** returnSession) {\
-		if (!(*returnSession = getHandle<JSONSession>(csound, handle, handleName))) {\
-			throw std::runtime_error(badHandle);\
-		}\
-        if (!jsonSession->active) throw std::runtime_error(deadHandle);\
-	}
+/*
+ Formatting of numbers with fractions in serialised text. A precision of 0
+ gives the shortest text which reads back as the same value, otherwise the
+ number of decimal places if fixed or significant digits if not
+ */
+struct NumberFormat {
+    NumberFormat(MYFLT precision = 0, MYFLT fixed = 0) :
+        precision((int) std::min(std::max(precision, FL(0)), FL(30))), fixed(fixed == FL(1)) {}
+    
+    int precision;
+    bool fixed;
+};
 
-#define _PLUGINITBASE(votypes, vitypes, doGetSession) \
-	ARGT* otypes = votypes;\
-	ARGT* itypes = vitypes;\
-	int init() {\
-        jsonDeinitSession = nullptr;\
-        handleDeinit = -1;\
-		try {\
-			if (doGetSession) getSession();\
-			irun();\
-		} catch (const std::exception &ex) {\
-			return csound->init_error(ex.what());\
-		}\
-		return OK;\
-	}
 
-// extension of above for k-rate opcodes
-#define _PLUGINITBASEK(votypes, vitypes, doGetSession) \
-    _PLUGINITBASE(votypes, vitypes, doGetSession)\
-    void irun() {}\
-    int kperf() {\
-        try {\
-            krun();\
-        } catch (const std::exception &ex) {\
-            return csound->perf_error(ex.what(), this);\
-        }\
-        return OK;\
+/*
+ Encoding event filter which formats doubles to a fixed precision with
+ numberformatting rather than snprintf, passing the text on as a bigint so that
+ an encoder with bigint_format set to number writes it unquoted. Actual bigints
+ are passed on as plain strings, so are quoted as with the default format.
+ Non-finite values are left to the encoder
+ */
+class NumberFormatFilter : public jsoncons::json_filter {
+public:
+    NumberFormatFilter(jsoncons::json_visitor& destination, const NumberFormat& format) :
+        jsoncons::json_filter(destination), format(format) {}
+    
+private:
+    bool visit_double(double value, jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        if (!std::isfinite(value)) {
+            return destination().double_value(value, tag, context, ec);
+        }
+        std::size_t length = numberformatting::formatDouble(value, format.precision, format.fixed, buffer);
+        return destination().string_value(jsoncons::string_view(buffer, length), jsoncons::semantic_tag::bigint, context, ec);
+    }
+    
+    bool visit_string(const string_view_type& value, jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        if (tag == jsoncons::semantic_tag::bigint) {
+            tag = jsoncons::semantic_tag::none;
+        }
+        return destination().string_value(value, tag, context, ec);
     }
+    
+    NumberFormat format;
+    char buffer[numberformatting::bufferSize];
+};
 
-#define PLUGINSESSION \
-    _PLUGINSESSIONBASE(inargs)
 
-#define INPLUGSESSION \
-    _PLUGINSESSIONBASE(args)
+/*
+ Serialise a JSON value to a jsoncons sink
+ */
+template <typename Sink>
+void encodeJson(const jsoncons::json& value, Sink&& sink, bool pretty, const NumberFormat& format) {
+    jsoncons::json_options options;
+    options.float_format((format.fixed) ? jsoncons::float_chars_format::fixed : jsoncons::float_chars_format::general);
+    if (format.precision > 0) {
+        options.bigint_format(jsoncons::bigint_chars_format::number);
+    }
+    std::unique_ptr<jsoncons::json_visitor> encoder;
+    if (pretty) {
+        encoder.reset(new jsoncons::basic_json_encoder<char, Sink>(std::forward<Sink>(sink), options));
+    } else {
+        encoder.reset(new jsoncons::basic_compact_json_encoder<char, Sink>(std::forward<Sink>(sink), options));
+    }
+    if (format.precision > 0) {
+        NumberFormatFilter filter(*encoder, format);
+        value.dump(filter);
+    } else {
+        value.dump(*encoder);
+    }
+}
 
-#define PLUGINIT(votypes, vitypes, doGetSession) \
-	_PLUGINITBASE(votypes, vitypes, doGetSession)
 
-#define INPLUGINIT(vitypes) \
-	_PLUGINITBASE("", vitypes, true)
+/*
+ Parser which consumes a buffer a chunk at a time, so that parsing of a large
+ document can be spread over time or abandoned part way through. The buffer
+ must remain valid until parsing is complete
+ */
+class ChunkedParser {
+public:
+    ChunkedParser(const char* data, size_t size) : data(data), size(size), position(0), complete(false) {}
+    
+    /*
+     Parse at least the given number of bytes if available, returning true when
+     the document is complete. Throws on invalid JSON
+     */
+    bool parse(size_t bytes) {
+        size_t consumed = 0;
+        while (!complete && !parser.stopped()) {
+            if (parser.source_exhausted() && position < size) {
+                if (consumed >= bytes) return false;
+                size_t length = std::min(bytes - consumed, size - position);
+                parser.update(data + position, length);
+                position += length;
+                consumed += length;
+            }
+            bool eof = parser.source_exhausted();
+            parser.parse_some(decoder);
+            if (eof) {
+                if (parser.enter()) {
+                    break;
+                } else if (!parser.accept()) {
+                    throw jsoncons::ser_error(jsoncons::json_errc::unexpected_eof, parser.line(), parser.column());
+                }
+            }
+        }
+        if (!complete) {
+            parser.check_done();
+            parser.update(data + position, size - position);
+            parser.check_done();
+            position = size;
+            complete = true;
+        }
+        return true;
+    }
+    
+    /*
+     Get the document once parsing is complete
+     */
+    jsoncons::json result() {
+        if (!decoder.is_valid()) {
+            throw std::runtime_error("could not parse JSON");
+        }
+        return decoder.get_result();
+    }
+    
+    size_t parsed() const {
+        return position;
+    }
+    
+private:
+    const char* data;
+    size_t size;
+    size_t position;
+    bool complete;
+    jsoncons::json_parser parser;
+    jsoncons::json_decoder<jsoncons::json> decoder;
+};
 
-#define PLUGINITK(votypes, vitypes, doGetSession) \
-	_PLUGINITBASEK(votypes, vitypes, doGetSession)
 
-#define INPLUGINITK(vitypes) \
-	_PLUGINITBASEK("", vitypes, true)
-            
-#define INPLUGCHILD(vitypes) \
-    INPLUGINIT(vitypes)\
-    void irun() { run(); }
+/*
+ Parse event filter which passes only the subtrees addressed by a set of JSON
+ Pointers on to a destination, along with the objects and arrays containing
+ them. Everything else is skipped as it is parsed, so is never allocated.
+ Items of containing arrays which are not selected are passed on as null so
+ that array indexes are unchanged
+ */
+class ProjectionFilter : public jsoncons::json_visitor {
+public:
+    ProjectionFilter(jsoncons::json_visitor& destination) : destination(destination), includeLevel(0), skipLevel(0) {}
+    
+    void addPointer(const char* text) {
+        jsoncons::jsonpointer::json_pointer pointer = jsoncons::jsonpointer::json_pointer(jsoncons::string_view(text));
+        selections.push_back(std::vector<std::string>(pointer.begin(), pointer.end()));
+    }
+    
+private:
+    enum Action { skip, include, descend };
+    
+    struct Frame {
+        bool isArray;
+        std::size_t index;
+        std::vector<std::size_t> candidates; // selections passing through this container
+    };
+    
+    /*
+     Determine what to do with the value about to be visited, setting the
+     selections which pass through it if it is to be descended into
+     */
+    Action classify(bool container) {
+        nextCandidates.clear();
+        if (frames.empty()) {
+            for (std::size_t i = 0; i < selections.size(); i++) {
+                if (selections[i].empty()) return include;
+                nextCandidates.push_back(i);
+            }
+        } else {
+            Frame& frame = frames.back();
+            std::size_t depth = frames.size() - 1;
+            if (frame.isArray) {
+                token = std::to_string(frame.index++);
+            } else {
+                token = key;
+            }
+            for (std::size_t candidate : frame.candidates) {
+                const std::vector<std::string>& selection = selections[candidate];
+                if (selection[depth] == token) {
+                    if (selection.size() == depth + 1) return include;
+                    nextCandidates.push_back(candidate);
+                }
+            }
+        }
+        return (container && !nextCandidates.empty()) ? descend : skip;
+    }
+    
+    bool beginContainer(bool isArray, jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) {
+        if (includeLevel > 0) {
+            includeLevel++;
+        } else if (skipLevel > 0) {
+            skipLevel++;
+            return true;
+        } else {
+            Action action = classify(true);
+            if (action == skip) {
+                skipLevel = 1;
+                return placeholder(context, ec);
+            }
+            if (!emitKey(context, ec)) return false;
+            if (action == include) {
+                includeLevel = 1;
+            } else {
+                frames.push_back(Frame());
+                frames.back().isArray = isArray;
+                frames.back().index = 0;
+                frames.back().candidates.swap(nextCandidates);
+            }
+        }
+        return (isArray) ? destination.begin_array(tag, context, ec) : destination.begin_object(tag, context, ec);
+    }
+    
+    bool endContainer(bool isArray, const jsoncons::ser_context& context, std::error_code& ec) {
+        if (includeLevel > 0) {
+            includeLevel--;
+        } else if (skipLevel > 0) {
+            skipLevel--;
+            return true;
+        } else {
+            frames.pop_back();
+        }
+        return (isArray) ? destination.end_array(context, ec) : destination.end_object(context, ec);
+    }
+    
+    /*
+     Check if a scalar value is to be passed on, passing on its key if so
+     */
+    bool acceptScalar(const jsoncons::ser_context& context, std::error_code& ec) {
+        if (includeLevel > 0) return true;
+        if (skipLevel > 0) return false;
+        if (classify(false) == include) {
+            return emitKey(context, ec);
+        }
+        placeholder(context, ec);
+        return false;
+    }
+    
+    bool emitKey(const jsoncons::ser_context& context, std::error_code& ec) {
+        if (!frames.empty() && !frames.back().isArray) {
+            return destination.key(key, context, ec);
+        }
+        return true;
+    }
+    
+    bool placeholder(const jsoncons::ser_context& context, std::error_code& ec) {
+        if (!frames.empty() && frames.back().isArray) {
+            return destination.null_value(jsoncons::semantic_tag::none, context, ec);
+        }
+        return true;
+    }
+    
+    void visit_flush() override {
+        destination.flush();
+    }
+    
+    bool visit_begin_object(jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        return beginContainer(false, tag, context, ec);
+    }
+    
+    bool visit_end_object(const jsoncons::ser_context& context, std::error_code& ec) override {
+        return endContainer(false, context, ec);
+    }
+    
+    bool visit_begin_array(jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        return beginContainer(true, tag, context, ec);
+    }
+    
+    bool visit_end_array(const jsoncons::ser_context& context, std::error_code& ec) override {
+        return endContainer(true, context, ec);
+    }
+    
+    bool visit_key(const string_view_type& name, const jsoncons::ser_context& context, std::error_code& ec) override {
+        if (includeLevel > 0) {
+            return destination.key(name, context, ec);
+        }
+        if (skipLevel == 0) {
+            key.assign(name.data(), name.size());
+        }
+        return true;
+    }
+    
+    bool visit_null(jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        return !acceptScalar(context, ec) || destination.null_value(tag, context, ec);
+    }
+    
+    bool visit_bool(bool value, jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        return !acceptScalar(context, ec) || destination.bool_value(value, tag, context, ec);
+    }
+    
+    bool visit_string(const string_view_type& value, jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        return !acceptScalar(context, ec) || destination.string_value(value, tag, context, ec);
+    }
+    
+    bool visit_byte_string(const jsoncons::byte_string_view& value, jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        return !acceptScalar(context, ec) || destination.byte_string_value(value, tag, context, ec);
+    }
+    
+    bool visit_uint64(uint64_t value, jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        return !acceptScalar(context, ec) || destination.uint64_value(value, tag, context, ec);
+    }
+    
+    bool visit_int64(int64_t value, jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        return !acceptScalar(context, ec) || destination.int64_value(value, tag, context, ec);
+    }
+    
+    bool visit_double(double value, jsoncons::semantic_tag tag, const jsoncons::ser_context& context, std::error_code& ec) override {
+        return !acceptScalar(context, ec) || destination.double_value(value, tag, context, ec);
+    }
+    
+    jsoncons::json_visitor& destination;
+    std::vector<std::vector<std::string>> selections;
+    std::vector<Frame> frames;
+    std::vector<std::size_t> nextCandidates;
+    std::string key;
+    std::string token;
+    int includeLevel; // nesting level within a selected subtree
+    int skipLevel; // nesting level within a skipped subtree
+};
 
-#define INPLUGCHILDK(vitypes) \
-    INPLUGINITK(vitypes)\
-    void krun() { run(); }
 
-#define PLUGINCHILD(votypes, vitypes, doGetSession) \
-    PLUGINIT(votypes, vitypes, doGetSession)\
+/*
+ Decode options for CSV files. The delimiter is given as a character code,
+ with 0 meaning a comma
+ */
+jsoncons::csv::csv_options csvOptions(MYFLT delimiter, jsoncons::csv::csv_mapping_kind mapping) {
+    jsoncons::csv::csv_options options;
+    options.field_delimiter((delimiter > 0) ? (char) delimiter : ',')
+        .mapping(mapping)
+        .assume_header(mapping != jsoncons::csv::csv_mapping_kind::n_rows);
+    return options;
+}
+
+
+/*
+ Reader for selected columns of CSV text, keeping their values as numbers in
+ one vector per column. Fields are scanned in place and only those of selected
+ columns are copied and converted. The first record gives the column names if
+ a header is expected. Quoted fields may contain delimiters, line breaks and
+ doubled quotes. Blank lines are skipped, and missing, empty and non-numeric
+ fields are stored as zero
+ */
+class CsvColumnReader {
+public:
+    CsvColumnReader(bool header, MYFLT delimiter) :
+        header(header), resolved(false), delimiter((delimiter > 0) ? (char) delimiter : ',') {}
+    
+    void selectColumn(std::size_t index) {
+        selections.push_back(index);
+        names.push_back(std::string());
+    }
+    
+    void selectColumn(const char* name) {
+        if (!header) {
+            throw std::runtime_error("columns can only be selected by name when the file has a header");
+        }
+        selections.push_back(0);
+        names.push_back(name);
+    }
+    
+    void read(const char* data, std::size_t size) {
+        const char* position = data;
+        const char* end = data + size;
+        if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+            position += 3;
+        }
+        while (position < end) {
+            if (*position == '\n' || *position == '\r') {
+                position++;
+                continue;
+            }
+            bool recordEnd = false;
+            if (header) {
+                while (!recordEnd) {
+                    position = readField(position, end, true, recordEnd);
+                    headings.push_back(field);
+                }
+                header = false;
+                continue;
+            }
+            resolve();
+            for (std::vector<MYFLT>& values : columns) {
+                values.push_back(0);
+            }
+            std::size_t column = 0;
+            while (!recordEnd) {
+                bool selected = column < slots.size() && !slots[column].empty();
+                position = readField(position, end, selected, recordEnd);
+                if (selected) {
+                    MYFLT value = toNumber();
+                    for (std::size_t slot : slots[column]) {
+                        columns[slot].back() = value;
+                    }
+                }
+                column++;
+            }
+        }
+        resolve();
+    }
+    
+    std::vector<std::vector<MYFLT>> columns;
+    
+private:
+    /*
+     Map column positions to output slots, once the header has been read if
+     there is one
+     */
+    void resolve() {
+        if (resolved) return;
+        resolved = true;
+        for (std::size_t slot = 0; slot < selections.size(); slot++) {
+            if (!names[slot].empty()) {
+                std::vector<std::string>::iterator found = std::find(headings.begin(), headings.end(), names[slot]);
+                if (found == headings.end()) {
+                    throw std::runtime_error("column not found: " + names[slot]);
+                }
+                selections[slot] = found - headings.begin();
+            }
+            if (selections[slot] >= slots.size()) {
+                slots.resize(selections[slot] + 1);
+            }
+            slots[selections[slot]].push_back(slot);
+        }
+        columns.resize(selections.size());
+    }
+    
+    /*
+     Scan one field, copying its unquoted contents if required, and step past
+     the delimiter or line break that ends it
+     */
+    const char* readField(const char* position, const char* end, bool keep, bool& recordEnd) {
+        field.clear();
+        if (position < end && *position == '"') {
+            position++;
+            while (position < end) {
+                char c = *position++;
+                if (c == '"') {
+                    if (position == end || *position != '"') break;
+                    position++;
+                }
+                if (keep) field += c;
+            }
+        }
+        const char* start = position;
+        while (position < end && *position != delimiter && *position != '\n' && *position != '\r') {
+            position++;
+        }
+        if (keep) field.append(start, position - start);
+        recordEnd = true;
+        if (position < end) {
+            if (*position == delimiter) {
+                recordEnd = false;
+                position++;
+            } else {
+                if (*position == '\r') position++;
+                if (position < end && *position == '\n') position++;
+            }
+        }
+        return position;
+    }
+    
+    MYFLT toNumber() {
+        if (field.empty() || strchr("+-.0123456789 ", field[0]) == nullptr) {
+            return 0;
+        }
+        try {
+            return (MYFLT) toDouble(field.c_str(), field.size());
+        } catch (const std::exception&) {
+            return 0;
+        }
+    }
+    
+    bool header; // first record is yet to be read as column names
+    bool resolved;
+    char delimiter;
+    std::string field;
+    NumberConverter toDouble;
+    std::vector<std::size_t> selections; // column position for each output slot
+    std::vector<std::string> names; // column name for each output slot, if selected by name
+    std::vector<std::string> headings;
+    std::vector<std::vector<std::size_t>> slots; // output slots for each column position
+};
+
+
+/*
+ Loads and parses a file on a worker thread. Destroying the loader cancels a
+ load in progress and waits for the worker to finish
+ */
+class AsyncFileLoader {
+public:
+    static const int loading = 0;
+    static const int ready = 1;
+    static const int failed = -1;
+    
+    jsoncons::json result;
+    std::string error;
+    double loadTime;
+    size_t loadBytes;
+    
+    AsyncFileLoader(const char* path) : loadTime(0), loadBytes(0), path(path), status(loading), cancelled(false) {
+        worker = std::thread(&AsyncFileLoader::run, this);
+    }
+    
+    ~AsyncFileLoader() {
+        cancelled = true;
+        worker.join();
+    }
+    
+    /*
+     Get the load status. Results are only valid once ready
+     */
+    int getStatus() const {
+        return status;
+    }
+    
+private:
+    void run() {
+        try {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            MappedFile file(path.c_str());
+            ChunkedParser parser(file.data(), file.size());
+            while (!parser.parse(ASYNCCHUNKSIZE)) {
+                if (cancelled) return;
+            }
+            result = parser.result();
+            loadBytes = file.size();
+            loadTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            status = ready;
+        } catch (const std::exception& ex) {
+            error = ex.what();
+            status = failed;
+        }
+    }
+    
+    std::string path;
+    std::atomic<int> status;
+    std::atomic<bool> cancelled;
+    std::thread worker;
+};
+
+
+/*
+ Path for a temporary file alongside the target, unique to the process and the
+ write so that concurrent writes to the same target do not collide
+ */
+std::string temporaryFilePath(const std::string& path) {
+    static std::atomic<unsigned long> counter(0);
+#if defined(_WIN32)
+    unsigned long process = (unsigned long) GetCurrentProcessId();
+#elif defined(FILEMAPPING_POSIX)
+    unsigned long process = (unsigned long) getpid();
+#else
+    unsigned long process = 0;
+#endif
+    char suffix[48];
+    snprintf(suffix, sizeof(suffix), ".%lu.%lu.tmp", process, ++counter);
+    return path + suffix;
+}
+
+
+/*
+ Write a file using the given function. When replacing, the file is written to
+ a temporary file alongside the target first and then moved over it, so that
+ readers never see a partially written file
+ */
+template <typename F>
+void writeFile(const std::string& path, std::ios::openmode mode, F write, bool replace = false) {
+    if (!replace) {
+        std::ofstream fileStream;
+        fileStream.open(path.c_str(), std::ios::out | std::ios::trunc | mode);
+        if (!fileStream.is_open()) {
+            throw std::runtime_error("could not open file for writing");
+        }
+        write(fileStream);
+        fileStream.close();
+        if (fileStream.fail()) {
+            throw std::runtime_error("could not write file");
+        }
+        return;
+    }
+    std::string temporaryPath = temporaryFilePath(path);
+    std::ofstream fileStream;
+    fileStream.open(temporaryPath.c_str(), std::ios::out | std::ios::trunc | mode);
+    if (!fileStream.is_open()) {
+        throw std::runtime_error("could not open file for writing");
+    }
+    try {
+        write(fileStream);
+    } catch (...) {
+        fileStream.close();
+        std::remove(temporaryPath.c_str());
+        throw;
+    }
+    fileStream.close();
+    if (fileStream.fail()) {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("could not write file");
+    }
+#if defined(_WIN32)
+    bool moved = MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool moved = std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!moved) {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("could not replace file");
+    }
+}
+
+
+/*
+ Serialise to a text file
+ */
+void writeJsonFile(const jsoncons::json& data, const std::string& path, bool pretty, const NumberFormat& format, bool replace = false) {
+    writeFile(path, std::ios::out, [&data, pretty, &format](std::ofstream& fileStream) {
+        encodeJson(data, jsoncons::stream_sink<char>(fileStream), pretty, format);
+    }, replace);
+}
+
+
+/*
+ Snapshot of a document queued to be written to file. The queue holds its own
+ reference, so a job may be abandoned by the opcode which submitted it without
+ waiting for the write to finish
+ */
+struct FileWriteJob {
+    static const int writing = 0;
+    static const int complete = 1;
+    static const int failed = -1;
+    
+    std::shared_ptr<const jsoncons::json> data;
+    std::string path;
+    bool pretty;
+    NumberFormat format;
+    std::string error; // set before status when failed
+    std::atomic<int> status;
+    
+    FileWriteJob(std::shared_ptr<const jsoncons::json> data, const char* path, bool pretty, const NumberFormat& format) :
+        data(std::move(data)), path(path), pretty(pretty), format(format), status(writing) {}
+};
+
+
+/*
+ Writes queued snapshots to file in order on one worker thread shared by all
+ background writes of a Csound instance, replacing each target through a
+ temporary file. The thread is started by the first job and stopped when
+ Csound is reset, once the jobs already queued have been written
+ */
+class FileWriteQueue {
+public:
+    FileWriteQueue() : stopping(false) {}
+    
+    ~FileWriteQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        condition.notify_one();
+        if (worker.joinable()) worker.join();
+    }
+    
+    void submit(const std::shared_ptr<FileWriteJob>& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!worker.joinable()) {
+                worker = std::thread(&FileWriteQueue::run, this);
+            }
+            jobs.push_back(job);
+        }
+        condition.notify_one();
+    }
+    
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            condition.wait(lock, [this] { return !jobs.empty() || stopping; });
+            if (jobs.empty()) return;
+            std::shared_ptr<FileWriteJob> job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+            int status = FileWriteJob::complete;
+            try {
+                writeJsonFile(*job->data, job->path, job->pretty, job->format, true);
+            } catch (const std::exception& ex) {
+                job->error = ex.what();
+                status = FileWriteJob::failed;
+            }
+            job->data.reset();
+            job->status = status;
+            job.reset();
+            lock.lock();
+        }
+    }
+    
+    std::deque<std::shared_ptr<FileWriteJob>> jobs;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::thread worker;
+};
+
+
+/*
+ Reset callback to stop the write queue when Csound is reset
+ */
+int destroyFileWriteQueue(CSOUND* csound, void* data) {
+    delete (FileWriteQueue*) data;
+    return OK;
+}
+
+
+/*
+ Get the write queue of a Csound instance, creating it if required
+ */
+FileWriteQueue* getFileWriteQueue(csnd::Csound* csound) {
+    FileWriteQueue** queue = (FileWriteQueue**) csound->query_global_variable(writeQueueName);
+    if (queue == NULL) {
+        csound->create_global_variable(writeQueueName, sizeof(FileWriteQueue*));
+        queue = (FileWriteQueue**) csound->query_global_variable(writeQueueName);
+        *queue = new FileWriteQueue();
+        csound->get_csound()->RegisterResetCallback(
+            csound->get_csound(), (void*) *queue, destroyFileWriteQueue
+        );
+    }
+    return *queue;
+}
+
+
+/*
+ Background writes for one opcode instance through the write queue, one at a
+ time. Destroying the writer abandons a write in progress without waiting for
+ it; the queue still completes it
+ */
+class AsyncFileWriter {
+public:
+    static const int none = 0;
+    static const int complete = FileWriteJob::complete;
+    static const int failed = FileWriteJob::failed;
+    
+    std::string error;
+    
+    AsyncFileWriter(FileWriteQueue* queue) : queue(queue) {}
+    
+    /*
+     Queue a snapshot to be written, returning false if a write is already in
+     progress
+     */
+    bool write(std::shared_ptr<const jsoncons::json> snapshot, const char* path, bool pretty, const NumberFormat& format) {
+        if (isBusy()) return false;
+        job = std::make_shared<FileWriteJob>(std::move(snapshot), path, pretty, format);
+        queue->submit(job);
+        return true;
+    }
+    
+    bool isBusy() const {
+        return job != nullptr && job->status == FileWriteJob::writing;
+    }
+    
+    /*
+     Get the result of the last finished write if it has not already been taken,
+     otherwise none. The error is valid when the result is failed
+     */
+    int takeResult() {
+        if (job == nullptr) return none;
+        int result = job->status;
+        if (result == FileWriteJob::writing) return none;
+        if (result == failed) error = job->error;
+        job.reset();
+        return result;
+    }
+    
+private:
+    FileWriteQueue* queue;
+    std::shared_ptr<FileWriteJob> job;
+};
+
+
+/*
+ Reads records from a JSON Lines file on a worker thread, parsing up to
+ LINESREADAHEAD records ahead of those requested. The byte offset of each
+ record is noted as the file is read, so that seeking to a record already
+ passed is immediate and seeking forwards only scans lines not yet seen
+ */
+class JSONLinesReader {
+public:
+    static const int available = 1;
+    static const int waiting = 0;
+    static const int finished = -1;
+    static const int invalid = -2;
+    
+    JSONLinesReader(const char* path) : buffer(LINESBUFFERSIZE), filePosition(0), recordIndex(0),
+        seekTarget(0), seeking(false), eof(false), stopping(false), generation(0) {
+        file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        file.open(path, std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("could not open file for reading");
+        }
+        worker = std::thread(&JSONLinesReader::run, this);
+    }
+    
+    ~JSONLinesReader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        condition.notify_one();
+        worker.join();
+    }
+    
+    /*
+     Take the next record if it has been read, setting the data and record index.
+     If the record could not be parsed, invalid is returned and the error set
+     */
+    int next(jsoncons::json& data, uint64_t& index, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (records.empty()) {
+            return (eof) ? finished : waiting;
+        }
+        Record& record = records.front();
+        index = record.index;
+        int result = available;
+        if (record.error.empty()) {
+            data = std::move(record.data);
+        } else {
+            error.swap(record.error);
+            result = invalid;
+        }
+        records.pop_front();
+        condition.notify_one();
+        return result;
+    }
+    
+    /*
+     Discard records read ahead and continue reading from the given record index
+     */
+    void seek(uint64_t index) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            records.clear();
+            eof = false;
+            seekTarget = index;
+            seeking = true;
+            generation++;
+        }
+        condition.notify_one();
+    }
+    
+private:
+    struct Record {
+        uint64_t index;
+        jsoncons::json data;
+        std::string error;
+    };
+    
+    void run() {
+        std::string line;
+        while (true) {
+            uint64_t target = 0;
+            bool doSeek;
+            uint64_t readGeneration;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] {
+                    return stopping || seeking || (!eof && records.size() < LINESREADAHEAD);
+                });
+                if (stopping) return;
+                doSeek = seeking;
+                if (seeking) {
+                    target = seekTarget;
+                    seeking = false;
+                }
+                readGeneration = generation;
+            }
+            if (doSeek) {
+                reposition(target);
+            }
+            
+            Record record;
+            bool found = readLine(line);
+            if (found) {
+                record.index = recordIndex++;
+                try {
+                    record.data = jsoncons::json::parse(line);
+                } catch (const std::exception& ex) {
+                    record.error = ex.what();
+                }
+            }
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            if (readGeneration != generation) continue;
+            if (found) {
+                records.push_back(std::move(record));
+            } else {
+                eof = true;
+            }
+        }
+    }
+    
+    /*
+     Read the next non-empty line, noting its offset if not already known
+     */
+    bool readLine(std::string& line) {
+        while (std::getline(file, line)) {
+            uint64_t offset = filePosition;
+            // the final line may have no newline, in which case getline sets eof
+            filePosition += line.size() + ((file.eof()) ? 0 : 1);
+            if (!line.empty() && line[line.size() - 1] == '\r') {
+                line.erase(line.size() - 1);
+            }
+            if (line.find_first_not_of(" \t") == std::string::npos) continue;
+            if (recordIndex == offsets.size()) {
+                offsets.push_back(offset);
+            }
+            return true;
+        }
+        return false;
+    }
+    
+    /*
+     Move the file to a record, scanning forward from the last known record if
+     its offset is not yet known
+     */
+    void reposition(uint64_t target) {
+        file.clear();
+        if (target < offsets.size()) {
+            recordIndex = target;
+        } else {
+            recordIndex = (offsets.empty()) ? 0 : offsets.size() - 1;
+        }
+        filePosition = (offsets.empty()) ? 0 : offsets[recordIndex];
+        file.seekg(filePosition);
+        std::string line;
+        while (recordIndex < target && readLine(line)) {
+            recordIndex++;
+        }
+    }
+    
+    std::vector<char> buffer;
+    std::ifstream file;
+    std::vector<uint64_t> offsets;
+    uint64_t filePosition;
+    uint64_t recordIndex;
+    
+    std::deque<Record> records;
+    uint64_t seekTarget;
+    bool seeking;
+    bool eof;
+    bool stopping;
+    uint64_t generation;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::thread worker;
+};
+
+
+/*
+ JSON Lines reader referenced by handle, shared with opcodes reading from it so
+ that closing the handle does not stop a reader in use
+ */
+struct JSONLinesSession {
+    std::shared_ptr<JSONLinesReader> reader;
+};
+
+
+/*
+    Initialise an array and return STRINDAT pointer in case it is required.
+    Existing storage is reused and only grown when the array is larger than the
+    allocated capacity, so that string members are kept for reuse
+ */
+STRINGDAT* arrayInit(csnd::Csound* csound, ARRAYDAT* array, int rows, int cols) {
+    int totalResults = rows * cols;
+    int dimensions = (cols != 1) ? 2 : 1;
+    size_t totalAllocated;
+    
+    // an array already initialised elsewhere may only have room for fewer sizes
+    if (array->sizes == NULL || array->dimensions < dimensions) {
+        array->sizes = (int32_t*) csound->realloc(array->sizes, sizeof(int32_t) * dimensions);
+    }
+    array->sizes[0] = rows;
+    if (cols != 1) {
+        array->sizes[1] = cols;
+    }
+    array->dimensions = dimensions;
+    if (array->arrayMemberSize == 0) {
+        CS_VARIABLE *var = array->arrayType->createVariable(csound->get_csound(), NULL);
+        array->arrayMemberSize = var->memBlockSize;
+    }
+    if ((totalAllocated = array->arrayMemberSize * totalResults) > array->allocated) {
+        array->data = (MYFLT*) csound->realloc(array->data, totalAllocated);
+        memset((char*)(array->data)+array->allocated, '\0', totalAllocated - array->allocated);
+        array->allocated = totalAllocated;
+    }
+    
+    // convenience return to be used if it is a string array
+    return (STRINGDAT*) array->data;
+}
+
+
+/*
+ Write to an output string, reusing the existing buffer and only growing it when
+ the value does not fit. STRINGDAT size holds the allocated size of the buffer
+ */
+void outputString(csnd::Csound* csound, STRINGDAT* output, const char* value, std::size_t length) {
+    if (output->data == NULL || (std::size_t) output->size < length + 1) {
+        std::size_t size = std::max(length + 1, (std::size_t) output->size * 2);
+        if (output->data != NULL) {
+            csound->free(output->data);
+        }
+        output->data = (char*) csound->malloc(size);
+        output->size = (int) size;
+    }
+    memcpy(output->data, value, length);
+    output->data[length] = '\0';
+}
+
+
+/*
+ Sink for jsoncons encoders which writes directly into the buffer of an output
+ string, so serialised text is not built up elsewhere and then copied. As with
+ outputString, the buffer is reused and grows geometrically when required,
+ leaving room for the terminator, which is written on flush
+ */
+class StringDatSink {
+public:
+    using value_type = char;
+    
+    StringDatSink(csnd::Csound* csound, STRINGDAT* output) : csound(csound), output(output), length(0) {}
+    
+    void push_back(char c) {
+        if (length + 2 > (std::size_t) output->size) grow(1);
+        output->data[length++] = c;
+    }
+    
+    void append(const char* value, std::size_t count) {
+        if (length + count + 1 > (std::size_t) output->size) grow(count);
+        memcpy(output->data + length, value, count);
+        length += count;
+    }
+    
+    void flush() {
+        if (output->data == NULL) grow(0);
+        output->data[length] = '\0';
+    }
+    
+private:
+    void grow(std::size_t count) {
+        std::size_t size = std::max(length + count + 1, (std::size_t) output->size * 2);
+        if (output->data == NULL) {
+            output->data = (char*) csound->malloc(size);
+        } else {
+            output->data = (char*) csound->realloc(output->data, size);
+        }
+        output->size = (int) size;
+    }
+    
+    csnd::Csound* csound;
+    STRINGDAT* output;
+    std::size_t length;
+};
+
+
+/*
+ Serialise a JSON value directly into an output string
+ */
+void outputJsonText(csnd::Csound* csound, STRINGDAT* output, const jsoncons::json& value, bool pretty, const NumberFormat& format = NumberFormat()) {
+    encodeJson(value, StringDatSink(csound, output), pretty, format);
+}
+
+
+/*
+ Text of a number, boolean or null written to a fixed size buffer, matching the
+ text given by jsoncons, so that string outputs of these values do not allocate
+ */
+struct ScalarText {
+    using value_type = char;
+    char data[64];
+    std::size_t size;
+    
+    ScalarText() : size(0) {}
+    
+    void push_back(char c) {
+        if (size < sizeof(data)) data[size++] = c;
+    }
+    
+    void append(const char* text) {
+        while (*text != '\0') push_back(*text++);
+    }
+    
+    /*
+     Write the text of a value, returning false if the type is not handled
+     */
+    bool write(const jsoncons::json& value) {
+        if (value.is_double()) {
+            double number = value.as_double();
+            if (!std::isfinite(number)) {
+                append("null");
+            } else {
+                jsoncons::detail::write_double writer(jsoncons::float_chars_format::general, 0);
+                writer(number, *this);
+            }
+        } else if (value.is_int64()) {
+            jsoncons::detail::from_integer(value.as<int64_t>(), *this);
+        } else if (value.is_uint64()) {
+            jsoncons::detail::from_integer(value.as<uint64_t>(), *this);
+        } else if (value.is_bool()) {
+            append(value.as_bool() ? "true" : "false");
+        } else if (value.is_null()) {
+            append("null");
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
+
+/*
+ Write a JSON value to an output string, avoiding a temporary copy if it is a
+ string and serialising objects and arrays directly into the output
+ */
+void outputJsonString(csnd::Csound* csound, STRINGDAT* output, const jsoncons::json& value) {
+    if (value.is_string()) {
+        jsoncons::string_view view = value.as_string_view();
+        outputString(csound, output, view.data(), view.size());
+    } else if (value.is_object() || value.is_array()) {
+        outputJsonText(csound, output, value, false);
+    } else {
+        ScalarText text;
+        if (text.write(value)) {
+            outputString(csound, output, text.data, text.size);
+        } else {
+            std::string converted = value.as<std::string>();
+            outputString(csound, output, converted.c_str(), converted.size());
+        }
+    }
+}
+
+
+/*
+ Write binary data to an output string as hexadecimal
+ */
+void outputHexString(csnd::Csound* csound, STRINGDAT* output, const std::vector<uint8_t>& bytes) {
+    std::string text;
+    text.reserve(bytes.size() * 2);
+    jsoncons::encode_base16(bytes.begin(), bytes.end(), text);
+    outputString(csound, output, text.c_str(), text.size());
+}
+
+
+/*
+ Get binary data from a hexadecimal string
+ */
+std::vector<uint8_t> hexStringToBytes(const STRINGDAT& input) {
+    std::vector<uint8_t> bytes;
+    jsoncons::string_view text(input.data);
+    if (jsoncons::decode_base16(text.begin(), text.end(), bytes).ec != jsoncons::conv_errc::success) {
+        throw std::runtime_error("invalid hexadecimal string");
+    }
+    return bytes;
+}
+
+
+/*
+ Write binary data to a numeric Csound array with one byte in each item
+ */
+void bytesToCSArray(csnd::Csound* csound, const std::vector<uint8_t>& bytes, ARRAYDAT* array) {
+    arrayInit(csound, array, bytes.size(), 1);
+    for (std::size_t i = 0; i < bytes.size(); i++) {
+        array->data[i] = (MYFLT) bytes[i];
+    }
+}
+
+
+/*
+ Get binary data from a numeric Csound array with one byte in each item
+ */
+std::vector<uint8_t> csArrayToBytes(ARRAYDAT* array) {
+    std::vector<uint8_t> bytes(array->sizes[0]);
+    for (int i = 0; i < array->sizes[0]; i++) {
+        bytes[i] = (uint8_t) array->data[i];
+    }
+    return bytes;
+}
+
+
+/*
+ Convert JSON array to numeric Csound array, reading numbers directly from the
+ document. Other types are converted from their string representation
+ */
+void jsonArrayToCSNumericArray(csnd::Csound* csound, const jsoncons::json& jdata, ARRAYDAT* array) {
+    std::size_t size = jdata.size();
+    arrayInit(csound, array, size, 1);
+    if (size == 0) return;
+    
+    MYFLT* data = array->data;
+    const jsoncons::json* items = &*jdata.array_range().begin();
+    std::size_t index = 0;
+    
+    // tight loop for the common case of an array of doubles
+    while (index < size && items[index].is_double()) {
+        data[index] = (MYFLT) items[index].as_double();
+        index++;
+    }
+    
+    for (; index < size; index++) {
+        const jsoncons::json& item = items[index];
+        if (item.is_number()) {
+            data[index] = (MYFLT) item.as_double();
+        } else {
+            data[index] = (MYFLT) atof(item.as<std::string>().c_str());
+        }
+    }
+}
+
+
+/*
+ Convert JSON array to Csound array either as string or numeric. Binary values
+ are converted to numeric arrays of byte values, read directly from the document
+ */
+void jsonArrayToCSArray(csnd::Csound* csound, const jsoncons::json* jdatap, ARRAYDAT* array, bool asString) {
+    const jsoncons::json& jdata = *jdatap;
+    if (!asString && jdata.is_byte_string()) {
+        jsoncons::byte_string_view bytes = jdata.as_byte_string_view();
+        arrayInit(csound, array, bytes.size(), 1);
+        for (std::size_t i = 0; i < bytes.size(); i++) {
+            array->data[i] = (MYFLT) bytes.data()[i];
+        }
+        return;
+    }
+    if (!jdata.is_array()) {
+        throw std::runtime_error(notArray);
+    }
+    
+    if (!asString) {
+        jsonArrayToCSNumericArray(csound, jdata, array);
+        return;
+    }
+    
+    STRINGDAT* strings = arrayInit(csound, array, jdata.size(), 1);
+    std::size_t index = 0;
+    for (const jsoncons::json& item : jdata.array_range()) {
+        outputJsonString(csound, &strings[index++], item);
+    }
+}
+
+
+/*
+ Skip over the value at the cursor, leaving the cursor at its last event
+ */
+void skipStreamValue(jsoncons::json_stream_cursor& cursor) {
+    jsoncons::staj_event_type type = cursor.current().event_type();
+    if (type != jsoncons::staj_event_type::begin_array && type != jsoncons::staj_event_type::begin_object) {
+        return;
+    }
+    int depth = 1;
+    while (depth > 0) {
+        cursor.next();
+        switch (cursor.current().event_type()) {
+            case jsoncons::staj_event_type::begin_array:
+            case jsoncons::staj_event_type::begin_object:
+                depth++;
+                break;
+            case jsoncons::staj_event_type::end_array:
+            case jsoncons::staj_event_type::end_object:
+                depth--;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+
+/*
+ Move the cursor to the start of the value addressed by a JSON Pointer, reading
+ no further into the document than required
+ */
+void seekStreamPointer(jsoncons::json_stream_cursor& cursor, const jsoncons::jsonpointer::json_pointer& pointer) {
+    using jsoncons::staj_event_type;
+    using jsoncons::jsonpointer::jsonpointer_errc;
+    using jsoncons::jsonpointer::jsonpointer_error;
+    for (const std::string& token : pointer) {
+        staj_event_type type = cursor.current().event_type();
+        if (type == staj_event_type::begin_object) {
+            cursor.next();
+            while (cursor.current().event_type() != staj_event_type::end_object) {
+                bool match = cursor.current().get<jsoncons::string_view>() == token;
+                cursor.next();
+                if (match) break;
+                skipStreamValue(cursor);
+                cursor.next();
+            }
+            if (cursor.current().event_type() == staj_event_type::end_object) {
+                throw jsonpointer_error(jsonpointer_errc::key_not_found);
+            }
+        } else if (type == staj_event_type::begin_array) {
+            if (token.empty() || token.find_first_not_of("0123456789") != std::string::npos) {
+                throw jsonpointer_error(jsonpointer_errc::invalid_index);
+            }
+            std::size_t index = std::stoul(token);
+            cursor.next();
+            for (std::size_t i = 0; i < index && cursor.current().event_type() != staj_event_type::end_array; i++) {
+                skipStreamValue(cursor);
+                cursor.next();
+            }
+            if (cursor.current().event_type() == staj_event_type::end_array) {
+                throw jsonpointer_error(jsonpointer_errc::index_exceeds_array_size);
+            }
+        } else {
+            throw jsonpointer_error(jsonpointer_errc::expected_object_or_array);
+        }
+    }
+}
+
+
+/*
+ Stream through a JSON file to the value addressed by a JSON Pointer, passing the
+ cursor positioned at the start of the value to a handler. Only the part of the
+ file up to the end of the value is read
+ */
+template <typename F>
+void streamFileValue(const char* path, const char* pointer, F handler) {
+    std::ifstream fileStream(path, std::ios::in | std::ios::binary);
+    if (!fileStream.is_open()) {
+        throw std::runtime_error("could not open file for reading");
+    }
+    jsoncons::json_stream_cursor cursor(fileStream);
+    seekStreamPointer(cursor, jsoncons::jsonpointer::json_pointer(jsoncons::string_view(pointer)));
+    handler(cursor);
+}
+
+
+/*
+ Read the value addressed by a JSON Pointer from a file without loading the rest
+ of the document
+ */
+jsoncons::json readFileValue(const char* path, const char* pointer) {
+    jsoncons::json_decoder<jsoncons::json> decoder;
+    streamFileValue(path, pointer, [&decoder](jsoncons::json_stream_cursor& cursor) {
+        cursor.read_to(decoder);
+    });
+    return decoder.get_result();
+}
+
+
+/*
+ Read the array at the cursor into a numeric Csound array, without building the
+ array as a JSON value first. Strings are converted, other types are zero
+ */
+void streamToCSNumericArray(csnd::Csound* csound, jsoncons::json_stream_cursor& cursor, ARRAYDAT* array) {
+    using jsoncons::staj_event_type;
+    if (cursor.current().event_type() != staj_event_type::begin_array) {
+        throw std::runtime_error(notArray);
+    }
+    std::vector<MYFLT> values;
+    cursor.next();
+    while (cursor.current().event_type() != staj_event_type::end_array) {
+        const jsoncons::staj_event& event = cursor.current();
+        switch (event.event_type()) {
+            case staj_event_type::double_value:
+            case staj_event_type::int64_value:
+            case staj_event_type::uint64_value:
+            case staj_event_type::half_value:
+                values.push_back((MYFLT) event.get<double>());
+                break;
+            case staj_event_type::string_value:
+                values.push_back((MYFLT) atof(event.get<std::string>().c_str()));
+                break;
+            default:
+                skipStreamValue(cursor);
+                values.push_back(0);
+                break;
+        }
+        cursor.next();
+    }
+    arrayInit(csound, array, values.size(), 1);
+    if (!values.empty()) {
+        memcpy(array->data, values.data(), sizeof(MYFLT) * values.size());
+    }
+}
+
+
+/*
+ Get the JSON type of a session object
+ */
+int getJsonType(JSONSession* jsonSession) {
+    const jsoncons::json& j = jsonSession->read();
+    int outtype = -1;
+    if (j.is_null()) {
+        outtype = 0;
+    } else if (j.is_string()) {
+        outtype = 1;
+    } else if (j.is_number()) {
+        outtype = 2;
+    } else if (j.is_bool()) {
+        outtype = 3;
+    } else if (j.is_array()) {
+        outtype = 4;
+    } else if (j.is_object()) {
+        outtype = 5;
+    }
+    return outtype;
+}
+
+// cs AppendOpcode mallocs struct so virtual functions cannot be used. 
+// Macro workaround to fake struct derivation type model, just chuck it all in a macro...
+
+#define _PLUGINSESSIONBASE(idInArgs)\
+    static constexpr bool keepsStaged = false; /* set by opcodes which only use staged members by key */\
+    JSONSession* jsonSession;\
+    MYFLT* deinitHandles;\
+    int deinitHandleCount;\
+    int deinitHandleCapacity;\
+    bool deinitRequired;\
+    bool deinitRegistered;\
+    void initMembers() {}\
+    int deinit() {\
+        return destroyLocalHandles();\
+    }\
+    void requireDeinit() {\
+        deinitRequired = true;\
+    }\
+    int destroyLocalHandles() {\
+        deinitRegistered = false; /* Csound removes the callback once it has been called */\
+        if (deinitHandles == nullptr) return OK;\
+        HandleRegistry<JSONSession>* registry = getRegistry<JSONSession>(csound, handleName);\
+        JSONSession* localSession;\
+        for (int i = 0; i < deinitHandleCount; i++) {\
+            localSession = registry->get(deinitHandles[i]);\
+            if (localSession != nullptr && localSession->local && localSession->owner == this) {\
+                registry->destroy(deinitHandles[i]);\
+            }\
+        }\
+        csound->free(deinitHandles);\
+        deinitHandles = nullptr;\
+        deinitHandleCount = 0;\
+        deinitHandleCapacity = 0;\
+        return OK;\
+    }\
+    void registerDeinit(MYFLT handle) {\
+        requireDeinit();\
+        if (deinitHandleCount == deinitHandleCapacity) {\
+            deinitHandleCapacity = (deinitHandleCapacity == 0) ? 8 : deinitHandleCapacity * 2;\
+            deinitHandles = (MYFLT*) csound->realloc(\
+                deinitHandles, sizeof(MYFLT) * deinitHandleCapacity\
+            );\
+        }\
+        deinitHandles[deinitHandleCount++] = handle;\
+    }\
+    MYFLT createSession(JSONSession** session, MYFLT local) {\
+        MYFLT handle = createHandle<JSONSession>(csound, session, handleName);\
+        if (local == FL(1)) {\
+            (*session)->local = true;\
+            (*session)->owner = this;\
+            registerDeinit(handle);\
+        }\
+        return handle;\
+    }\
+    MYFLT createSession(JSONSession** session, const jsoncons::json& selected, MYFLT local, MYFLT view) {\
+        MYFLT handle = createSession(session, local);\
+        if (view == FL(1)) {\
+            (*session)->view = &selected;\
+            if (jsonSession->view != nullptr) {\
+                (*session)->viewParent = jsonSession->viewParent;\
+                (*session)->viewParentVersion = jsonSession->viewParentVersion;\
+            } else {\
+                (*session)->viewParent = idInArgs[0];\
+                (*session)->viewParentVersion = jsonSession->version;\
+            }\
+        } else {\
+            (*session)->assign(selected);\
+        }\
+        return handle;\
+    }\
+    HandleRegistry<JSONSession>* sessions;\
+    void getSession(bool materialise = true) {\
+        getSession(idInArgs[0], &jsonSession, materialise);\
+    }\
+    void getSession(MYFLT handle, JSONSession** returnSession, bool materialise = true) {\
+        sessions = getRegistry<JSONSession>(csound, handleName);\
+        if (!(*returnSession = sessions->get(handle))) {\
+            throw std::runtime_error(sessions->isStale(handle) ? deadHandle : badHandle);\
+        }\
+        if ((*returnSession)->pending) {\
+            throw std::runtime_error(loadingHandle);\
+        }\
+        checkView(*returnSession);\
+        if (materialise) (*returnSession)->materialise();\
+    }\
+    void checkSession(bool materialise = true) {\
+        if (!(jsonSession = sessions->get(idInArgs[0]))) {\
+            throw std::runtime_error(deadHandle);\
+        }\
+        if (jsonSession->pending) {\
+            throw std::runtime_error(loadingHandle);\
+        }\
+        checkView(jsonSession);\
+        if (materialise) jsonSession->materialise();\
+    }\
+    std::shared_ptr<const jsoncons::json> snapshotSession() {\
+        return jsonSession->snapshot((jsonSession->view == nullptr) ? nullptr : sessions->get(jsonSession->viewParent));\
+    }\
+    void checkView(JSONSession* session) {\
+        if (session->view != nullptr) {\
+            JSONSession* parent = sessions->get(session->viewParent);\
+            if (parent == nullptr || parent->version != session->viewParentVersion) {\
+                throw std::runtime_error(staleView);\
+            }\
+        }\
+    }
+
+#define _PLUGINITBASE(votypes, vitypes, doGetSession) \
+	ARGT* otypes = votypes;\
+	ARGT* itypes = vitypes;\
+	int init() {\
+        /* members are kept when initialised again before deinit, as in i-time loops and reinit. */\
+        /* deinitRegistered is otherwise false, as Csound zero fills new opcode memory and deinit clears it */\
+        if (!deinitRegistered) {\
+            deinitHandles = nullptr;\
+            deinitHandleCount = 0;\
+            deinitHandleCapacity = 0;\
+            deinitRequired = false;\
+            initMembers();\
+        }\
+        int result = OK;\
+		try {\
+			if (doGetSession) getSession(!keepsStaged);\
+			irun();\
+		} catch (const std::exception &ex) {\
+			result = csound->init_error(ex.what());\
+		}\
+        registerRequiredDeinit();\
+		return result;\
+	}\
+    /* register deinit once, from the most derived opcode so that its own deinit is called */\
+    void registerRequiredDeinit() {\
+        if (deinitRequired && !deinitRegistered) {\
+            csound->plugin_deinit(this);\
+            deinitRegistered = true;\
+        }\
+    }
+
+// extension of above for k-rate opcodes
+#define _PLUGINITBASEK(votypes, vitypes, doGetSession) \
+    _PLUGINITBASE(votypes, vitypes, doGetSession)\
+    void irun() {}\
+    int kperf() {\
+        int result = OK;\
+        try {\
+            if (doGetSession) checkSession(!keepsStaged);\
+            krun();\
+        } catch (const std::exception &ex) {\
+            result = csound->perf_error(ex.what(), this);\
+        }\
+        registerRequiredDeinit();\
+        return result;\
+    }
+
+// cached JSON Pointer from the second argument, for opcodes which use one
+#define _PLUGINPOINTERBASE(idInArgs)\
+    JSONPointerHolder* pointerHolder;\
+    void initMembers() {\
+        pointerHolder = nullptr;\
+    }\
+    JSONPointerHolder& getPointer() {\
+        if (pointerHolder == nullptr) {\
+            pointerHolder = new JSONPointerHolder();\
+            requireDeinit();\
+        }\
+        pointerHolder->parse(idInArgs.str_data(1).data);\
+        return *pointerHolder;\
+    }\
+    int deinit() {\
+        delete pointerHolder;\
+        pointerHolder = nullptr;\
+        return destroyLocalHandles();\
+    }
+
+#define PLUGINSESSION \
+    _PLUGINSESSIONBASE(inargs)
+
+#define INPLUGSESSION \
+    _PLUGINSESSIONBASE(args)
+
+#define PLUGINPOINTER \
+    _PLUGINPOINTERBASE(inargs)
+
+#define INPLUGPOINTER \
+    _PLUGINPOINTERBASE(args)
+
+#define PLUGINIT(votypes, vitypes, doGetSession) \
+	_PLUGINITBASE(votypes, vitypes, doGetSession)
+
+#define INPLUGINIT(vitypes) \
+	_PLUGINITBASE("", vitypes, true)
+
+#define PLUGINITK(votypes, vitypes, doGetSession) \
+	_PLUGINITBASEK(votypes, vitypes, doGetSession)
+
+#define INPLUGINITK(vitypes) \
+	_PLUGINITBASEK("", vitypes, true)
+            
+#define INPLUGCHILD(vitypes) \
+    INPLUGINIT(vitypes)\
+    void irun() { run(); }
+
+#define INPLUGCHILDK(vitypes) \
+    INPLUGINITK(vitypes)\
+    void krun() { run(); }
+
+#define PLUGINCHILD(votypes, vitypes, doGetSession) \
+    PLUGINIT(votypes, vitypes, doGetSession)\
     void irun() { run(); }
 
-#define PLUGINCHILDK(votypes, vitypes, doGetSession) \
-    PLUGINITK(votypes, vitypes, doGetSession)\
-    void krun() { run(); }
+#define PLUGINCHILDK(votypes, vitypes, doGetSession) \
+    PLUGINITK(votypes, vitypes, doGetSession)\
+    void krun() { run(); }
+
+
+
+template <std::size_t N> 
+struct inplug : csnd::InPlug<N> {
+    using csnd::InPlug<N>::args;
+    using csnd::InPlug<N>::csound;
+    INPLUGSESSION
+};
+
+template <std::size_t N, std::size_t M> 
+struct plugin : csnd::Plugin<N, M> {
+    using csnd::Plugin<N, M>::inargs;
+    using csnd::Plugin<N, M>::outargs;
+    using csnd::Plugin<N, M>::csound;
+    PLUGINSESSION
+};
+
+
+/*
+ Parse JSON object from a provided string
+ */
+struct jsonloads : plugin<1, 4> {
+	PLUGINIT("i", "Sopo", false)
+	void irun() {
+        jsoncons::json parsed = parseJson(jsoncons::string_view(inargs.str_data(0).data), inargs[2] != FL(0));
+        outargs[0] = createSession(&jsonSession, inargs[1]);
+        jsonSession->assign(std::move(parsed));
+        jsonSession->storage = (int) inargs[3];
+	}
+};
+
+
+/*
+ Initialise an empty JSON object
+ */
+struct jsoninit : plugin<1, 2> {
+	PLUGINIT("i", "oo", false)
+	void irun() {
+        outargs[0] = createSession(&jsonSession, inargs[0]);
+        jsonSession->assign(jsoncons::json::parse("{}"));
+        jsonSession->storage = (int) inargs[1];
+	}
+};
+
+
+/*
+ Merge two JSON objects
+ */
+struct jsonmerge : inplug<3> {
+	INPLUGINIT("iio")
+	void irun() {        
+        JSONSession* jsonSession2;
+        getSession(args[1], &jsonSession2);
+        if (args[2] == 1) { 
+            jsonSession->write().merge_or_update(jsonSession2->read());
+        } else {
+            jsonSession->write().merge(jsonSession2->read());
+        }
+	}
+};
+
+
+/*
+ Insert a JSON object to another JSON object with specified key
+ */
+struct jsoninsert : inplug<3> {
+    static constexpr bool keepsStaged = true;
+	INPLUGINIT("iSi")
+	void irun() {
+        JSONSession* jsonSession2;
+        getSession(args[2], &jsonSession2);
+        jsonSession->insert(
+            std::string(args.str_data(1).data),
+            jsoncons::json(jsonSession2->read())
+        );
+	}
+};
+
+
+/*
+Insert an array of JSON objects to another JSON object with specified key        
+*/      
+struct jsoninsertArray : inplug<3> {
+    static constexpr bool keepsStaged = true;
+	INPLUGINIT("iSi[]")
+	void irun() {      
+        JSONSession* jsonSession2;
+        ARRAYDAT* values = (ARRAYDAT*) args(2);
+        std::vector<jsoncons::json> valuesVector;
+        
+        for (int i = 0; i < values->sizes[0]; i++) {
+            getSession(values->data[i], &jsonSession2);
+            valuesVector.push_back(jsonSession2->read());
+        }
+               
+        jsonSession->insert(
+            std::string(args.str_data(1).data),
+            jsoncons::json(valuesVector)
+        );
+	}
+};
+
+
+/*
+ Insert a string value to a JSON object with specified key
+ */
+struct jsoninsertvalStringBase : inplug<3> {
+    static constexpr bool keepsStaged = true;
+    void run() {
+        jsonSession->insert(
+            std::string(args.str_data(1).data),
+            jsoncons::json(std::string(args.str_data(2).data))
+        );
+	}
+};
+struct jsoninsertvalString : jsoninsertvalStringBase {
+	INPLUGCHILD("iSS")
+};
+struct jsoninsertvalStringK : jsoninsertvalStringBase {
+	INPLUGCHILDK("iSS")
+};
+
+
+/*
+ Insert a numeric value to a JSON object with specified key
+ */
+struct jsoninsertvalNumericBase : inplug<3> {
+    static constexpr bool keepsStaged = true;
+    void run() {
+        jsonSession->insert(
+            std::string(args.str_data(1).data),
+            jsoncons::json(args[2])
+        );  
+    }
+};
+struct jsoninsertvalNumeric : jsoninsertvalNumericBase { 
+    INPLUGCHILD("iSi") 
+};
+struct jsoninsertvalNumericK : jsoninsertvalNumericBase { 
+    INPLUGCHILDK("iSk") 
+};
+
+
+
+/*
+ Insert a numeric array to a JSON object with specified key
+ */
+struct jsoninsertvalNumericArrayBase : inplug<3> {
+    static constexpr bool keepsStaged = true;
+    void run() {
+        ARRAYDAT* values = (ARRAYDAT*) args(2);
+        jsoncons::json items(jsoncons::json_array_arg);
+        items.reserve(values->sizes[0]);
+        for (int i = 0; i < values->sizes[0]; i++) {
+            items.emplace_back((double) values->data[i]);
+        }
+        jsonSession->insert(
+            std::string(args.str_data(1).data),
+            std::move(items)
+        );
+    }
+};
+struct jsoninsertvalNumericArray : jsoninsertvalNumericArrayBase { 
+    INPLUGCHILD("iSi[]") 
+};
+struct jsoninsertvalNumericArrayK : jsoninsertvalNumericArrayBase { 
+    INPLUGCHILDK("iSk[]") 
+};
+
+
+
+/*
+ Insert a string array to a JSON object with specified key
+ */
+struct jsoninsertvalStringArrayBase : inplug<3> {
+    static constexpr bool keepsStaged = true;
+	void run() { 
+        ARRAYDAT* values = (ARRAYDAT*) args(2);
+        STRINGDAT* strings = (STRINGDAT*) values->data;
+        std::vector<std::string> valuesVector;
+        for (int i = 0; i < values->sizes[0]; i++) {
+            valuesVector.push_back(std::string(strings[i].data));
+        }
+        jsonSession->insert(
+            std::string(args.str_data(1).data),
+            jsoncons::json(valuesVector)
+        );
+	}
+};
+struct jsoninsertvalStringArray : jsoninsertvalStringArrayBase { 
+    INPLUGCHILD("iSS[]") 
+};
+struct jsoninsertvalStringArrayK : jsoninsertvalStringArrayBase { 
+    INPLUGCHILDK("iSS[]") 
+};
+
+
+/*
+ Insert string key, string value pairs to a JSON object with specified key
+ */
+struct jsoninsertvalStringStringArrayBase : inplug<3> {
+    static constexpr bool keepsStaged = true;
+    void run() {
+        ARRAYDAT* rawKeys = (ARRAYDAT*) args(1);
+        STRINGDAT* keys = (STRINGDAT*) rawKeys->data;
+        ARRAYDAT* rawValues = (ARRAYDAT*) args(2);
+        STRINGDAT* values = (STRINGDAT*) rawValues->data;
+        if (rawKeys->sizes[0] != rawValues->sizes[0]) {
+            throw std::runtime_error("key and value arrays are not the same size");
+        }
+        for (int i = 0; i < rawKeys->sizes[0]; i++) {
+            jsonSession->insert(
+                std::string(keys[i].data),
+                jsoncons::json(std::string(values[i].data))
+            );
+        }
+    }
+};
+struct jsoninsertvalStringStringArray : jsoninsertvalStringStringArrayBase {
+    INPLUGCHILD("iS[]S[]")
+};
+struct jsoninsertvalStringStringArrayK : jsoninsertvalStringStringArrayBase {
+    INPLUGCHILDK("iS[]S[]")
+};
+ 
+
+/*
+ Insert string key, numeric value pairs to a JSON object with specified key
+ */
+struct jsoninsertvalStringNumericArrayBase : inplug<3> {
+    static constexpr bool keepsStaged = true;
+    void run() {
+        ARRAYDAT* rawKeys = (ARRAYDAT*) args(1);
+        STRINGDAT* keys = (STRINGDAT*) rawKeys->data;
+        ARRAYDAT* rawValues = (ARRAYDAT*) args(2);
+        if (rawKeys->sizes[0] != rawValues->sizes[0]) {
+            throw std::runtime_error("key and value arrays are not the same size");
+        }
+        for (int i = 0; i < rawKeys->sizes[0]; i++) {
+            jsonSession->insert(
+                std::string(keys[i].data),
+                jsoncons::json(rawValues->data[i]) // not like doubles?
+            );
+        }
+    }
+};
+struct jsoninsertvalStringNumericArray : jsoninsertvalStringNumericArrayBase {
+    INPLUGCHILD("iS[]i[]")
+};
+struct jsoninsertvalStringNumericArrayK : jsoninsertvalStringNumericArrayBase {
+    INPLUGCHILDK("iS[]k[]")
+};
+
+
+/*
+ Get JSON type as number
+ */
+struct jsontype : plugin<1, 1> {
+	PLUGINIT("i", "i", true)
+    void irun() {
+        outargs[0] = (MYFLT) getJsonType(jsonSession);
+    }
+};
+
+/*
+ Get JSON type as string
+ */
+struct jsontypeString : plugin<1, 1> {
+	PLUGINIT("S", "i", true)
+    void irun() {
+        static const char* typeNames[] = {
+            "unknown", "null", "string", "number", "boolean", "array", "object"
+        };
+        const char* output = typeNames[getJsonType(jsonSession) + 1];
+        outputString(csound, &outargs.str_data(0), output, strlen(output));
+    }
+};
+
+/*
+ Get the key names from an object
+ */
+struct jsonkeysBase : plugin<1, 1> {
+    void run() {
+        const jsoncons::json& data = jsonSession->read();
+        if (!data.is_object()) {
+            throw std::runtime_error(notObject);
+        }
+        ARRAYDAT* array = (ARRAYDAT*) outargs(0);
+        STRINGDAT* strings = arrayInit(csound, array, data.size(), 1);
+        
+        int index = 0;
+        for (const auto& member : data.object_range()) {
+            outputString(csound, &strings[index], member.key().data(), member.key().size());
+            index ++;
+        }
+    }
+};
+struct jsonkeys : jsonkeysBase {
+    PLUGINCHILD("S[]", "i", true)
+};
+struct jsonkeysK : jsonkeysBase {
+    PLUGINCHILDK("S[]", "i", true)
+};
+
+
+/* 
+ Get the size of a JSON object
+ */
+struct jsonsizeBase : plugin<1, 1> {
+    static constexpr bool keepsStaged = true;
+    void run() {
+        outargs[0] = (MYFLT) jsonSession->size();
+    }
+};
+struct jsonsize : jsonsizeBase {
+    PLUGINCHILD("i", "i", true)
+};
+struct jsonsizeK : jsonsizeBase {
+    PLUGINCHILDK("k", "i", true)
+};
+
+
+/*
+ Get string value by string key
+ */
+struct jsongetvalStringStringBase : plugin<1, 2> {
+    static constexpr bool keepsStaged = true;
+    void run() {
+        STRINGDAT &input = inargs.str_data(1);
+        STRINGDAT &output = outargs.str_data(0);
+        const jsoncons::json& selected = jsonSession->member(input.data);
+        outputJsonString(csound, &output, selected);
+    }
+};
+struct jsongetvalStringString : jsongetvalStringStringBase {
+    PLUGINCHILD("S", "iS", true)
+};
+struct jsongetvalStringStringK : jsongetvalStringStringBase {
+    PLUGINCHILDK("S", "iS", true)
+};
+
+
+/*
+ Get numeric value by string key
+ */
+struct jsongetvalNumericStringBase : plugin<1, 2> {
+    static constexpr bool keepsStaged = true;
+    void run() {
+        STRINGDAT &input = inargs.str_data(1);
+        const jsoncons::json& selected = jsonSession->member(input.data);
+        outargs[0] = selected.as<MYFLT>();
+    }
+};
+struct jsongetvalNumericString : jsongetvalNumericStringBase {
+    PLUGINCHILD("i", "iS", true)
+};
+struct jsongetvalNumericStringK : jsongetvalNumericStringBase {
+    PLUGINCHILDK("k", "iS", true)
+};
+
+
+/*
+ Get string value by numeric index
+ */
+struct jsongetvalStringNumericBase : plugin<1, 2> {
+    void run() {
+        STRINGDAT &output = outargs.str_data(0);
+        const jsoncons::json& selected = jsonSession->read().at((std::size_t) inargs[1]);
+        outputJsonString(csound, &output, selected);
+    }
+};
+struct jsongetvalStringNumeric : jsongetvalStringNumericBase {
+    PLUGINCHILD("S", "ii", true)
+};
+struct jsongetvalStringNumericK : jsongetvalStringNumericBase {
+    PLUGINCHILDK("S", "ik", true)
+};
+
+
+/*
+ Get numeric value by numeric index
+ */
+struct jsongetvalNumericNumericBase : plugin<1, 2> {
+    void run() {
+        const jsoncons::json& selected = jsonSession->read().at((std::size_t) inargs[1]);
+        outargs[0] = selected.as<MYFLT>();
+    }
+};
+struct jsongetvalNumericNumeric : jsongetvalNumericNumericBase {
+    PLUGINCHILD("i", "ii", true)
+};
+struct jsongetvalNumericNumericK : jsongetvalNumericNumericBase {
+    PLUGINCHILDK("k", "ik", true)
+};
+
+
+
+/*
+ Get object from an object by key name
+ */
+struct jsongetString : plugin<1, 4> {
+    PLUGINIT("i", "iSoo", true)
+    void irun() {
+        STRINGDAT &input = inargs.str_data(1);
+        JSONSession* jsonSessionOutput;
+        outargs[0] = createSession(
+            &jsonSessionOutput, jsonSession->read().at(input.data), inargs[2], inargs[3]
+        );
+    }
+};
+
+
+/*
+ Get object from an array by index
+ */
+struct jsongetNumeric : plugin<1, 4> {
+    PLUGINIT("i", "iioo", true)
+    void irun() {
+        JSONSession* jsonSessionOutput;
+        outargs[0] = createSession(
+            &jsonSessionOutput, jsonSession->read().at((int) inargs[1]), inargs[2], inargs[3]
+        );
+    }
+};
+
+
+/*
+ Query by JSONPath
+ */
+struct jsonpath : plugin<1, 3> {
+	PLUGINIT("i", "iSo", true)
+    void irun() {
+        JSONSession* jsonSessionOutput;
+        outargs[0] = createSession(&jsonSessionOutput, inargs[2]);
+        jsonSessionOutput->assign(compilePath<JSONPathQuery>(
+            std::string(inargs.str_data(1).data)
+        )->evaluate(jsonSession->read()));
+    }
+};
+
+
+/*
+ Replace value by JSONPath, keeping the compiled expression for the opcode lifetime
+ */
+struct jsonpathrplvalBase : inplug<3> {
+    JSONPathHolder<JSONPathReplace>* compiledPath;
+    void initMembers() {
+        compiledPath = nullptr;
+    }
+    void replace(const jsoncons::json& value) {
+        if (compiledPath == nullptr) {
+            compiledPath = new JSONPathHolder<JSONPathReplace>();
+            requireDeinit();
+        }
+        compiledPath->get(args.str_data(1).data).evaluate(
+            jsonSession->write(),
+            [&value](const std::string&, jsoncons::json& target) {
+                target = value;
+            },
+            jsoncons::jsonpath::result_options::nodups
+        );
+    }
+    int deinit() {
+        delete compiledPath;
+        compiledPath = nullptr;
+        return destroyLocalHandles();
+    }
+};
+
+
+/*
+ Replace string value by JSONPath
+ */
+struct jsonpathrplvalStringBase : jsonpathrplvalBase {
+	void run() {
+        replace(jsoncons::json(args.str_data(2).data));
+	}
+};
+struct jsonpathrplvalString : jsonpathrplvalStringBase {
+	INPLUGCHILD("iSS")
+};
+struct jsonpathrplvalStringK : jsonpathrplvalStringBase {
+	INPLUGCHILDK("iSS")
+};
+
+
+/*
+ Replace numeric value by JSONPath
+ */
+struct jsonpathrplvalNumericBase : jsonpathrplvalBase {
+	void run() {
+        replace(jsoncons::json((double) args[2]));
+	}
+};
+struct jsonpathrplvalNumeric : jsonpathrplvalNumericBase {
+	INPLUGCHILD("iSi")
+};
+struct jsonpathrplvalNumericK : jsonpathrplvalNumericBase {
+	INPLUGCHILDK("iSk")
+};
+
+
+/*
+ Get JSONPath expression cache statistics
+ */
+struct jsonpathstats : plugin<3, 0> {
+    PLUGINIT("iii", "", false)
+    void irun() {
+        LRUCache<JSONPathQuery>& queries = getPathCache<JSONPathQuery>();
+        LRUCache<JSONPathReplace>& replaces = getPathCache<JSONPathReplace>();
+        outargs[0] = (MYFLT) (queries.getHits() + replaces.getHits());
+        outargs[1] = (MYFLT) (queries.getMisses() + replaces.getMisses());
+        outargs[2] = (MYFLT) (queries.size() + replaces.size());
+    }
+};
+
+
+/*
+ Replace element with object by JSONPath
+ NOT SUPPORTED
+struct jsonpathrpl : inplug<3> {
+	INPLUGINIT("iSi")
+	void irun() {
+        JSONSession* jsonSession2;
+        getSession(args[2], &jsonSession2);
+        jsoncons::jsonpath::json_replace(
+            jsonSession->write(), 
+            std::string(args.str_data(1).data), 
+            jsonSession2->read()
+        );
+	}
+};
+*/
+
+/*
+ Query by JSON Pointer
+ */
+struct jsonptr : plugin<1, 4> {
+	PLUGINIT("i", "iSoo", true)
+    void irun() {
+        const jsoncons::json& queried = jsoncons::jsonpointer::get(
+            jsonSession->read(), std::string(inargs.str_data(1).data)
+        );
+        JSONSession* jsonSessionOutput;
+        outargs[0] = createSession(&jsonSessionOutput, queried, inargs[2], inargs[3]);
+    }
+};
+
+
+/*
+ Get string value by JSON Pointer
+ */
+struct jsonptrvalStringBase : plugin<1, 2> {
+    PLUGINPOINTER
+    void run() {
+        STRINGDAT &output = outargs.str_data(0);
+        const jsoncons::json& queried = getPointer().get(jsonSession, inargs[0]);
+        outputJsonString(csound, &output, queried);
+    }
+};
+struct jsonptrvalString : jsonptrvalStringBase {
+	PLUGINCHILD("S", "iS", true)
+};
+struct jsonptrvalStringK : jsonptrvalStringBase {
+	PLUGINCHILDK("S", "iS", true)
+};
+
+
+/*
+ Get string array value by JSON Pointer
+ */
+struct jsonptrvalStringArrayBase : plugin<1, 2> {
+    PLUGINPOINTER
+    void run() {
+        const jsoncons::json& queried = getPointer().get(jsonSession, inargs[0]);
+        jsonArrayToCSArray(csound, &queried, (ARRAYDAT*) outargs(0), true);
+    }
+};
+struct jsonptrvalStringArray : jsonptrvalStringArrayBase {
+	PLUGINCHILD("S[]", "iS", true)
+};
+struct jsonptrvalStringArrayK : jsonptrvalStringArrayBase {
+	PLUGINCHILDK("S[]", "iS", true)
+};
+
 
+/*
+ Get numeric value by JSON Pointer
+ */
+struct jsonptrvalNumericBase : plugin<1, 2> {
+    PLUGINPOINTER
+    void run() {
+        outargs[0] = getPointer().get(jsonSession, inargs[0]).as<MYFLT>();
+    }
+};
+struct jsonptrvalNumeric : jsonptrvalNumericBase {
+	PLUGINCHILD("i", "iS", true)
+};
+struct jsonptrvalNumericK : jsonptrvalNumericBase {
+	PLUGINCHILDK("k", "iS", true)
+};
 
 
-template <std::size_t N> 
-struct inplug : csnd::InPlug<N> {
-    using csnd::InPlug<N>::args;
-    using csnd::InPlug<N>::csound;
-    INPLUGSESSION
+/*
+ Get numeric array value by JSON Pointer
+ */
+struct jsonptrvalNumericArrayBase : plugin<1, 2> {
+    PLUGINPOINTER
+    void run() {
+        const jsoncons::json& queried = getPointer().get(jsonSession, inargs[0]);
+        jsonArrayToCSArray(csound, &queried, (ARRAYDAT*) outargs(0), false);
+    }
+};
+struct jsonptrvalNumericArray : jsonptrvalNumericArrayBase {
+	PLUGINCHILD("i[]", "iS", true)
+};
+struct jsonptrvalNumericArrayK : jsonptrvalNumericArrayBase {
+	PLUGINCHILDK("k[]", "iS", true)
 };
 
-template <std::size_t N, std::size_t M> 
-struct plugin : csnd::Plugin<N, M> {
-    using csnd::Plugin<N, M>::inargs;
-    using csnd::Plugin<N, M>::outargs;
-    using csnd::Plugin<N, M>::csound;
-    PLUGINSESSION
+
+/*
+ Get numeric array value by JSON Pointer
+ */
+struct jsonptrarr : plugin<1, 4> {
+    PLUGINIT("i[]", "iSoo", true)
+    void irun() {
+        JSONSession* jsonSession2;
+        const jsoncons::json& queried = jsoncons::jsonpointer::get(
+            jsonSession->read(), std::string(inargs.str_data(1).data)
+        );
+        if (!queried.is_array()) {
+            throw std::runtime_error(notArray);
+        }
+        ARRAYDAT* array = (ARRAYDAT*) outargs(0);
+        arrayInit(csound, array, queried.size(), 1);
+        std::size_t index = 0;
+        for (const jsoncons::json& item : queried.array_range()) {
+            array->data[index++] = createSession(&jsonSession2, item, inargs[2], inargs[3]);
+        }
+    }
 };
 
 
 /*
- Parse JSON object from a provided string
+ Check for existence by JSON Pointer
  */
-struct jsonloads : plugin<1, 1> {
-	PLUGINIT("i", "S", false)
-	void irun() {
-        outargs[0] = createHandle<JSONSession>(csound, &jsonSession, handleName);
-        jsonSession->active = true;
-        jsonSession->data = jsoncons::json::parse(std::string(inargs.str_data(0).data));
-        //registerDeinit(jsonSession, outargs[0]);
-	}
+struct jsonptrhasBase : plugin<1, 2> {
+    PLUGINPOINTER
+    void run() {
+        outargs[0] = (getPointer().find(jsonSession, inargs[0]) != nullptr) ? FL(1) : FL(0);
+    }
+};
+struct jsonptrhas : jsonptrhasBase {
+	PLUGINCHILD("i", "iS", true)
+};
+struct jsonptrhasK : jsonptrhasBase {
+	PLUGINCHILDK("k", "iS", true)
 };
 
 
 /*
- Initialise an empty JSON object
+ Add string value by JSON Pointer
  */
-struct jsoninit : plugin<1, 0> {
-	PLUGINIT("i", "", false)
-	void irun() {
-        outargs[0] = createHandle<JSONSession>(csound, &jsonSession, handleName);
-        jsonSession->active = true;
-        jsonSession->data = jsoncons::json::parse("{}");
-        //registerDeinit(jsonSession, outargs[0]);
+struct jsonptraddvalStringBase : inplug<3> {
+    INPLUGPOINTER
+	void run() {
+        const jsoncons::jsonpointer::json_pointer& pointer = getPointer().pointer;
+        jsoncons::jsonpointer::add(
+            jsonSession->write(), 
+            pointer, 
+            jsoncons::json(args.str_data(2).data),
+            true // create if not exists
+        );
 	}
 };
+struct jsonptraddvalString : jsonptraddvalStringBase {
+    INPLUGCHILD("iSS")
+};
+struct jsonptraddvalStringK : jsonptraddvalStringBase {
+    INPLUGCHILDK("iSS")
+};
 
 
 /*
- Merge two JSON objects
+ Add numeric value by JSON Pointer
  */
-struct jsonmerge : inplug<3> {
-	INPLUGINIT("iio")
-	void irun() {        
-        JSONSession* jsonSession2;
-        getSession(args[1], &jsonSession2);
-        if (args[2] == 1) { 
-            jsonSession->data.merge_or_update(jsonSession2->data);
-        } else {
-            jsonSession->data.merge(jsonSession2->data);
-        }
+struct jsonptraddvalNumericBase : inplug<3> {
+    INPLUGPOINTER
+	void run() {
+        const jsoncons::jsonpointer::json_pointer& pointer = getPointer().pointer;
+        jsoncons::jsonpointer::add(
+            jsonSession->write(), 
+            pointer, 
+            args[2],
+            true // create if not exists
+        );
 	}
 };
+struct jsonptraddvalNumeric : jsonptraddvalNumericBase {
+	INPLUGCHILD("iSi")
+};
+struct jsonptraddvalNumericK : jsonptraddvalNumericBase {
+	INPLUGCHILDK("iSk")
+};
 
 
 /*
- Insert a JSON object to another JSON object with specified key
+ Add object by JSON Pointer
  */
-struct jsoninsert : inplug<3> {
+struct jsonptradd : inplug<3> {
 	INPLUGINIT("iSi")
 	void irun() {
         JSONSession* jsonSession2;
         getSession(args[2], &jsonSession2);
-        jsonSession->data.insert_or_assign(
-            std::string(args.str_data(1).data),
-            jsonSession2->data
+        
+        jsoncons::jsonpointer::add(
+            jsonSession->write(), 
+            std::string(args.str_data(1).data), 
+            jsonSession2->read(),
+            true // create if not exists
         );
 	}
 };
 
 
 /*
-Insert an array of JSON objects to another JSON object with specified key        
-*/      
-struct jsoninsertArray : inplug<3> {
-	INPLUGINIT("iSi[]")
-	void irun() {      
-        JSONSession* jsonSession2;
-        ARRAYDAT* values = (ARRAYDAT*) args(2);
-        std::vector<jsoncons::json> valuesVector;
-        
-        for (int i = 0; i < values->sizes[0]; i++) {
-            getSession(values->data[i], &jsonSession2);
-            valuesVector.push_back(jsonSession2->data);
-        }
-               
-        jsonSession->data.insert_or_assign(
-            std::string(args.str_data(1).data),
-            valuesVector
-        );
+ Remove by JSON Pointer
+ */
+struct jsonptrrmBase : inplug<2> {
+    INPLUGPOINTER
+	void run() {
+        const jsoncons::jsonpointer::json_pointer& pointer = getPointer().pointer;
+        jsoncons::jsonpointer::remove(jsonSession->write(), pointer);
 	}
 };
+struct jsonptrrm : jsonptrrmBase {
+	INPLUGCHILD("iS")
+};
+struct jsonptrrmK : jsonptrrmBase {
+	INPLUGCHILDK("iS")
+};
 
 
 /*
- Insert a string value to a JSON object with specified key
+ Replace string value by JSON Pointer
  */
-struct jsoninsertvalStringBase : inplug<3> {
-    void run() {
-        jsonSession->data.insert_or_assign(
-            std::string(args.str_data(1).data),
-            std::string(args.str_data(2).data)
-        );
+struct jsonptrrplvalStringBase : inplug<3> {
+    INPLUGPOINTER
+	void run() {
+        getPointer().replace(jsonSession, args[0], jsoncons::json(args.str_data(2).data));
 	}
 };
-struct jsoninsertvalString : jsoninsertvalStringBase {
+struct jsonptrrplvalString : jsonptrrplvalStringBase {
 	INPLUGCHILD("iSS")
 };
-struct jsoninsertvalStringK : jsoninsertvalStringBase {
+struct jsonptrrplvalStringK : jsonptrrplvalStringBase {
 	INPLUGCHILDK("iSS")
 };
 
 
 /*
- Insert a numeric value to a JSON object with specified key
+ Replace numeric value by JSON Pointer
  */
-struct jsoninsertvalNumericBase : inplug<3> {
-    void run() {
-        jsonSession->data.insert_or_assign(
-            std::string(args.str_data(1).data),
-            args[2]
-        );  
-    }
+struct jsonptrrplvalNumericBase : inplug<3> {
+    INPLUGPOINTER
+	void run() {
+        getPointer().replace(jsonSession, args[0], jsoncons::json(args[2]));
+	}
 };
-struct jsoninsertvalNumeric : jsoninsertvalNumericBase { 
-    INPLUGCHILD("iSi") 
+struct jsonptrrplvalNumeric : jsonptrrplvalNumericBase {
+	INPLUGCHILD("iSi")
 };
-struct jsoninsertvalNumericK : jsoninsertvalNumericBase { 
-    INPLUGCHILDK("iSk") 
+struct jsonptrrplvalNumericK : jsonptrrplvalNumericBase {
+	INPLUGCHILDK("iSk")
 };
 
 
-
 /*
- Insert a numeric array to a JSON object with specified key
+ Replace object by JSON Pointer
  */
-struct jsoninsertvalNumericArrayBase : inplug<3> {
-    void run() {
-        ARRAYDAT* values = (ARRAYDAT*) args(2);
-        std::vector<MYFLT> valuesVector(values->data, values->data + values->sizes[0]);
-        jsonSession->data.insert_or_assign(
-            std::string(args.str_data(1).data),
-            valuesVector
+struct jsonptrrpl : csnd::InPlug<3> {
+    INPLUGSESSION
+	INPLUGINIT("iSi")
+	void irun() {
+        JSONSession* jsonSession2;
+        getSession(args[2], &jsonSession2);
+        
+        jsoncons::jsonpointer::replace(
+            jsonSession->write(), 
+            std::string(args.str_data(1).data), 
+            jsonSession2->read(),
+            true // create if missing
         );
-    }
-};
-struct jsoninsertvalNumericArray : jsoninsertvalNumericArrayBase { 
-    INPLUGCHILD("iSi[]") 
-};
-struct jsoninsertvalNumericArrayK : jsoninsertvalNumericArrayBase { 
-    INPLUGCHILDK("iSk[]") 
+	}
 };
 
 
-
 /*
- Insert a string array to a JSON object with specified key
+ Get numeric array from object
  */
-struct jsoninsertvalStringArrayBase : inplug<3> {	
-	void run() { 
-        ARRAYDAT* values = (ARRAYDAT*) args(2);
-        STRINGDAT* strings = (STRINGDAT*) values->data;
-        std::vector<std::string> valuesVector;
-        for (int i = 0; i < values->sizes[0]; i++) {
-            valuesVector.push_back(std::string(strings[i].data));
-        }
-        jsonSession->data.insert_or_assign(
-            std::string(args.str_data(1).data),
-            valuesVector
-        );
-	}
+struct jsonarrvalNumericBase : plugin<1, 1> {
+    void run() {
+        jsonArrayToCSArray(csound, &(jsonSession->read()), (ARRAYDAT*) outargs(0), false);         
+    }
 };
-struct jsoninsertvalStringArray : jsoninsertvalStringArrayBase { 
-    INPLUGCHILD("iSS[]") 
+struct jsonarrvalNumeric : jsonarrvalNumericBase {
+	PLUGINCHILD("i[]", "i", true)
 };
-struct jsoninsertvalStringArrayK : jsoninsertvalStringArrayBase { 
-    INPLUGCHILDK("iSS[]") 
+struct jsonarrvalNumericK : jsonarrvalNumericBase {
+	PLUGINCHILDK("k[]", "i", true)
 };
 
 
 /*
- Insert string key, string value pairs to a JSON object with specified key
+ Get string array from object
  */
-struct jsoninsertvalStringStringArrayBase : inplug<3> {
+struct jsonarrvalStringBase : plugin<1, 1> {
     void run() {
-        ARRAYDAT* rawKeys = (ARRAYDAT*) args(1);
-        STRINGDAT* keys = (STRINGDAT*) rawKeys->data;
-        ARRAYDAT* rawValues = (ARRAYDAT*) args(2);
-        STRINGDAT* values = (STRINGDAT*) rawValues->data;
-        if (rawKeys->sizes[0] != rawValues->sizes[0]) {
-            throw std::runtime_error("key and value arrays are not the same size");
-        }
-        for (int i = 0; i < rawKeys->sizes[0]; i++) {
-            jsonSession->data.insert_or_assign(
-                std::string(keys[i].data),
-                std::string(values[i].data)
-            );
-        }
+        jsonArrayToCSArray(csound, &(jsonSession->read()), (ARRAYDAT*) outargs(0), true);         
     }
 };
-struct jsoninsertvalStringStringArray : jsoninsertvalStringStringArrayBase {
-    INPLUGCHILD("iS[]S[]")
+struct jsonarrvalString : jsonarrvalStringBase {
+	PLUGINCHILD("S[]", "i", true)
 };
-struct jsoninsertvalStringStringArrayK : jsoninsertvalStringStringArrayBase {
-    INPLUGCHILDK("iS[]S[]")
+struct jsonarrvalStringK : jsonarrvalStringBase {
+	PLUGINCHILDK("S[]", "i", true)
 };
- 
+
 
 /*
- Insert string key, numeric value pairs to a JSON object with specified key
+ Get array of object handles from object
  */
-struct jsoninsertvalStringNumericArrayBase : inplug<3> {
-    void run() {
-        ARRAYDAT* rawKeys = (ARRAYDAT*) args(1);
-        STRINGDAT* keys = (STRINGDAT*) rawKeys->data;
-        ARRAYDAT* rawValues = (ARRAYDAT*) args(2);
-        if (rawKeys->sizes[0] != rawValues->sizes[0]) {
-            throw std::runtime_error("key and value arrays are not the same size");
+struct jsonarr : plugin<1, 3> {
+    PLUGINIT("i[]", "ioo", true)
+    void irun() {
+        JSONSession* jsonSession2;
+        const jsoncons::json& data = jsonSession->read();
+        if (!data.is_array()) {
+            throw std::runtime_error(notArray);
         }
-        for (int i = 0; i < rawKeys->sizes[0]; i++) {
-            jsonSession->data.insert_or_assign(
-                std::string(keys[i].data),
-                rawValues->data[i] // not like doubles?
-            );
+        ARRAYDAT* array = (ARRAYDAT*) outargs(0);
+        arrayInit(csound, array, data.size(), 1);
+        std::size_t index = 0;
+        for (const jsoncons::json& item : data.array_range()) {
+            array->data[index++] = createSession(&jsonSession2, item, inargs[1], inargs[2]);
         }
     }
 };
-struct jsoninsertvalStringNumericArray : jsoninsertvalStringNumericArrayBase {
-    INPLUGCHILD("iS[]i[]")
+
+
+/*
+ Dump to string, encoding directly into the output buffer
+ */
+struct jsondumpsBase : plugin<1, 4> {
+	void run() {
+        outputJsonText(csound, &outargs.str_data(0), jsonSession->read(), inargs[1] == FL(1), NumberFormat(inargs[2], inargs[3]));
+	}
+};
+struct jsondumps : jsondumpsBase {
+	PLUGINCHILD("S", "ipoo", true)
 };
-struct jsoninsertvalStringNumericArrayK : jsoninsertvalStringNumericArrayBase {
-    INPLUGCHILDK("iS[]k[]")
+struct jsondumpsK : jsondumpsBase {
+	PLUGINCHILDK("S", "ipoo", true)
 };
 
 
 /*
- Get JSON type as number
+ Destroy object and clear memory
  */
-struct jsontype : plugin<1, 1> {
-	PLUGINIT("i", "i", true)
+struct jsondestroy : inplug<1> {
+    INPLUGINIT("i")
     void irun() {
-        outargs[0] = (MYFLT) getJsonType(jsonSession);
+        destroyHandle<JSONSession>(csound, args[0], handleName);
+        jsonSession = nullptr;
     }
 };
 
+
 /*
- Get JSON type as string
+ Promote a local object to global so it is not destroyed at instrument end. A
+ view is copied from its parent first, as it would otherwise become invalid
+ when a local parent is destroyed
  */
-struct jsontypeString : plugin<1, 1> {
-	PLUGINIT("S", "i", true)
+struct jsonpromote : inplug<1> {
+    INPLUGINIT("i")
     void irun() {
-        STRINGDAT &sdoutput = outargs.str_data(0);
-        int type = getJsonType(jsonSession);
-        std::string output;
-        switch (type) {
-            case -1:
-                output.assign("unknown");
-                break;
+        if (jsonSession->view != nullptr) {
+            jsonSession->write();
+        }
+        jsonSession->local = false;
+    }
+};
+
+
+/*
+ Load from file, parsing directly from the mapped file contents
+ */
+struct jsonload : plugin<1, 3> {
+	PLUGINIT("i", "Sop", false)
+	void irun() {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        MappedFile file(inargs.str_data(0).data);
+        jsoncons::json parsed = parseJson(jsoncons::string_view(file.data(), file.size()), inargs[2] != FL(0));
+        outargs[0] = createSession(&jsonSession, inargs[1]);
+        jsonSession->assign(std::move(parsed));
+        jsonSession->loadBytes = file.size();
+        jsonSession->loadTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+	}
+};
+
+
+/*
+ Load only the parts of a file addressed by a set of JSON Pointers, discarding
+ everything else as the file is parsed
+ */
+struct jsonloadproj : plugin<1, 3> {
+	PLUGINIT("i", "SS[]o", false)
+	void irun() {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ARRAYDAT* pointers = (ARRAYDAT*) inargs(1);
+        STRINGDAT* pointerStrings = (STRINGDAT*) pointers->data;
+        jsoncons::json_decoder<jsoncons::json> decoder;
+        ProjectionFilter filter(decoder);
+        for (int i = 0; i < pointers->sizes[0]; i++) {
+            filter.addPointer(pointerStrings[i].data);
+        }
+        MappedFile file(inargs.str_data(0).data);
+        jsoncons::json_string_reader reader(jsoncons::string_view(file.data(), file.size()), filter);
+        reader.read();
+        outargs[0] = createSession(&jsonSession, inargs[2]);
+        if (decoder.is_valid()) {
+            jsonSession->assign(decoder.get_result());
+        }
+        jsonSession->loadBytes = file.size();
+        jsonSession->loadTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+	}
+};
+
+
+/*
+ Load a CSV file as an array of objects keyed by the header (mode 0), an array
+ of arrays of all fields (mode 1) or an object of column arrays keyed by the
+ header (mode 2)
+ */
+struct jsonloadcsv : plugin<1, 4> {
+	PLUGINIT("i", "Sooo", false)
+	void irun() {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        jsoncons::csv::csv_mapping_kind mapping;
+        switch ((int) inargs[1]) {
             case 0:
-                output.assign("null");
+                mapping = jsoncons::csv::csv_mapping_kind::n_objects;
                 break;
             case 1:
-                output.assign("string");
+                mapping = jsoncons::csv::csv_mapping_kind::n_rows;
                 break;
             case 2:
-                output.assign("number");
-                break;
-            case 3:
-                output.assign("boolean");
-                break;
-            case 4:
-                output.assign("array");
-                break;
-            case 5:
-                output.assign("object");
+                mapping = jsoncons::csv::csv_mapping_kind::m_columns;
                 break;
+            default:
+                throw std::runtime_error("invalid mode");
         }
-        sdoutput.size = output.length();
-        sdoutput.data = csound->strdup((char*) output.c_str());
-    }
+        MappedFile file(inargs.str_data(0).data);
+        jsoncons::json parsed = jsoncons::csv::decode_csv<jsoncons::json>(
+            jsoncons::string_view(file.data(), file.size()), csvOptions(inargs[2], mapping)
+        );
+        outargs[0] = createSession(&jsonSession, inargs[3]);
+        jsonSession->assign(std::move(parsed));
+        jsonSession->loadBytes = file.size();
+        jsonSession->loadTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+	}
 };
 
+
 /*
- Get the key names from an object
+ Read selected columns of a CSV file directly into a numeric array without
+ creating an object. The output is always one dimensional, with the selected
+ columns stored one after another
  */
-struct jsonkeysBase : plugin<1, 1> {
-    void run() {
-        std::map<std::string, jsoncons::json> map = 
-                jsonSession->data.as<std::map<std::string, jsoncons::json>>();
-        ARRAYDAT* array = (ARRAYDAT*) outargs(0);
-        STRINGDAT* strings = arrayInit(csound, array, map.size(), 1);
+struct jsonloadcsvcolsBase : plugin<1, 4> {
+    void readColumns(CsvColumnReader& columns) {
+        MappedFile file(inargs.str_data(0).data);
+        columns.read(file.data(), file.size());
         
-        char* value;
-        int index = 0;
-        for (auto const& x : map) {
-            value = (char*) x.first.c_str();
-            insertArrayStringItem(csound, strings, index, value);
-            index ++;
+        ARRAYDAT* array = (ARRAYDAT*) outargs(0);
+        std::size_t rows = (columns.columns.empty()) ? 0 : columns.columns[0].size();
+        arrayInit(csound, array, columns.columns.size() * rows, 1);
+        MYFLT* output = array->data;
+        for (const std::vector<MYFLT>& values : columns.columns) {
+            std::copy(values.begin(), values.end(), output);
+            output += values.size();
         }
     }
 };
-struct jsonkeys : jsonkeysBase {
-    PLUGINCHILD("S[]", "i", true)
+
+struct jsonloadcsvcolsNumeric : jsonloadcsvcolsBase {
+	PLUGINIT("i[]", "Si[]po", false)
+    void irun() {
+        ARRAYDAT* indexes = (ARRAYDAT*) inargs(1);
+        CsvColumnReader columns(inargs[2] != FL(0), inargs[3]);
+        for (int i = 0; i < indexes->sizes[0]; i++) {
+            if (indexes->data[i] < 0) {
+                throw std::runtime_error("invalid column index");
+            }
+            columns.selectColumn((std::size_t) indexes->data[i]);
+        }
+        readColumns(columns);
+    }
 };
-struct jsonkeysK : jsonkeysBase {
-    PLUGINCHILDK("S[]", "i", true)
+
+struct jsonloadcsvcolsString : jsonloadcsvcolsBase {
+	PLUGINIT("i[]", "SS[]po", false)
+    void irun() {
+        ARRAYDAT* names = (ARRAYDAT*) inargs(1);
+        STRINGDAT* nameStrings = (STRINGDAT*) names->data;
+        CsvColumnReader columns(inargs[2] != FL(0), inargs[3]);
+        for (int i = 0; i < names->sizes[0]; i++) {
+            columns.selectColumn(nameStrings[i].data);
+        }
+        readColumns(columns);
+    }
 };
 
 
-/* 
- Get the size of a JSON object
+/*
+ Load from file on a background thread. The handle is returned immediately but
+ may only be used once the status output is 1. The status is -1 and the handle
+ destroyed if loading fails
  */
-struct jsonsizeBase : plugin<1, 1> {    
-    void run() {
-        outargs[0] = (MYFLT) jsonSession->data.size();
+struct jsonloadasync : plugin<2, 2> {
+    PLUGINIT("ik", "So", false)
+    AsyncFileLoader* loader;
+    MYFLT handle;
+    MYFLT status;
+    
+    void initMembers() {
+        loader = nullptr;
+    }
+    
+    void irun() {
+        sessions = getRegistry<JSONSession>(csound, handleName);
+        handle = outargs[0] = createSession(&jsonSession, inargs[1]);
+        jsonSession->pending = true;
+        status = AsyncFileLoader::loading;
+        requireDeinit();
+        loader = new AsyncFileLoader(inargs.str_data(0).data);
+    }
+    
+    int kperf() {
+        if (loader != nullptr && loader->getStatus() != AsyncFileLoader::loading) {
+            status = loader->getStatus();
+            JSONSession* session = sessions->get(handle);
+            if (session != nullptr) {
+                if (status == AsyncFileLoader::ready) {
+                    session->assign(std::move(loader->result));
+                    session->loadTime = loader->loadTime;
+                    session->loadBytes = loader->loadBytes;
+                    session->pending = false;
+                } else {
+                    csound->message("jsonloadasync: " + loader->error);
+                    sessions->destroy(handle);
+                }
+            }
+            delete loader;
+            loader = nullptr;
+        }
+        outargs[1] = status;
+        return OK;
+    }
+    
+    int deinit() {
+        delete loader;
+        loader = nullptr;
+        JSONSession* session = sessions->get(handle);
+        if (session != nullptr && session->pending) {
+            sessions->destroy(handle);
+        }
+        return destroyLocalHandles();
     }
-};
-struct jsonsize : jsonsizeBase {
-    PLUGINCHILD("i", "i", true)
-};
-struct jsonsizeK : jsonsizeBase {
-    PLUGINCHILDK("k", "i", true)
 };
 
 
 /*
- Get string value by string key
+ Parse JSON object from a provided string over a number of control cycles, so
+ that large strings do not need to be parsed within one cycle. The handle is
+ returned immediately but may only be used once the status output is 1. The
+ status is -1 and the handle destroyed if parsing fails
  */
-struct jsongetvalStringStringBase : plugin<1, 2> {
-    void run() {
-        STRINGDAT &input = inargs.str_data(1);
-        STRINGDAT &output = outargs.str_data(0);
-        jsoncons::json selected = jsonSession->data[std::string(input.data)];
-        std::string value = selected.as<std::string>();
-        output.size = value.size();
-        output.data = csound->strdup((char*) value.c_str());
+struct jsonloadsinc : plugin<2, 4> {
+    PLUGINIT("ik", "SkOo", false)
+    std::string* text;
+    ChunkedParser* parser;
+    MYFLT handle;
+    MYFLT status;
+    
+    void initMembers() {
+        text = nullptr;
+        parser = nullptr;
+    }
+    
+    void irun() {
+        sessions = getRegistry<JSONSession>(csound, handleName);
+        handle = outargs[0] = createSession(&jsonSession, inargs[3]);
+        jsonSession->pending = true;
+        status = AsyncFileLoader::loading;
+        requireDeinit();
+        text = new std::string(inargs.str_data(0).data);
+        parser = new ChunkedParser(text->data(), text->size());
+    }
+    
+    /*
+     Parse up to the byte and time limits for this cycle, returning true when complete
+     */
+    bool parseSome() {
+        size_t limit = (inargs[1] > 0) ? (size_t) inargs[1] : SIZE_MAX;
+        if (inargs[2] <= 0) {
+            return parser->parse(limit);
+        }
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now()
+            + std::chrono::microseconds((long long) inargs[2]);
+        size_t start = parser->parsed();
+        while (true) {
+            size_t consumed = parser->parsed() - start;
+            if (parser->parse(std::min((size_t) INCREMENTALCHUNKSIZE, limit - consumed))) {
+                return true;
+            }
+            if (parser->parsed() - start >= limit || std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+        }
+    }
+    
+    int kperf() {
+        if (parser != nullptr) {
+            try {
+                if (parseSome()) {
+                    JSONSession* session = sessions->get(handle);
+                    if (session != nullptr) {
+                        session->assign(parser->result());
+                        session->pending = false;
+                    }
+                    status = AsyncFileLoader::ready;
+                    release();
+                }
+            } catch (const std::exception& ex) {
+                csound->message(std::string("jsonloadsinc: ") + ex.what());
+                status = AsyncFileLoader::failed;
+                sessions->destroy(handle);
+                release();
+            }
+        }
+        outargs[1] = status;
+        return OK;
+    }
+    
+    void release() {
+        delete parser;
+        parser = nullptr;
+        delete text;
+        text = nullptr;
+    }
+    
+    int deinit() {
+        release();
+        JSONSession* session = sessions->get(handle);
+        if (session != nullptr && session->pending) {
+            sessions->destroy(handle);
+        }
+        return destroyLocalHandles();
     }
-};
-struct jsongetvalStringString : jsongetvalStringStringBase {
-    PLUGINCHILD("S", "iS", true)
-};
-struct jsongetvalStringStringK : jsongetvalStringStringBase {
-    PLUGINCHILDK("S", "iS", true)
 };
 
 
 /*
- Get numeric value by string key
+ Get string value by JSON Pointer from a file, streaming through the file
  */
-struct jsongetvalNumericStringBase : plugin<1, 2> {
-    void run() {
-        STRINGDAT &input = inargs.str_data(1);
-        jsoncons::json selected = jsonSession->data[std::string(input.data)];
-        outargs[0] = selected.as<MYFLT>();
+struct jsonloadvalString : plugin<1, 2> {
+    PLUGINIT("S", "SS", false)
+    void irun() {
+        jsoncons::json value = readFileValue(inargs.str_data(0).data, inargs.str_data(1).data);
+        outputJsonString(csound, &outargs.str_data(0), value);
     }
 };
-struct jsongetvalNumericString : jsongetvalNumericStringBase {
-    PLUGINCHILD("i", "iS", true)
-};
-struct jsongetvalNumericStringK : jsongetvalNumericStringBase {
-    PLUGINCHILDK("k", "iS", true)
-};
 
 
 /*
- Get string value by numeric index
+ Get string array value by JSON Pointer from a file, streaming through the file
  */
-struct jsongetvalStringNumericBase : plugin<1, 2> {
-    void run() {
-        STRINGDAT &output = outargs.str_data(0);
-        jsoncons::json selected = jsonSession->data[(int) inargs[1]];
-        std::string value = selected.as<std::string>();
-        output.size = value.size();
-        output.data = csound->strdup((char*) value.c_str());
+struct jsonloadvalStringArray : plugin<1, 2> {
+    PLUGINIT("S[]", "SS", false)
+    void irun() {
+        jsoncons::json value = readFileValue(inargs.str_data(0).data, inargs.str_data(1).data);
+        jsonArrayToCSArray(csound, &value, (ARRAYDAT*) outargs(0), true);
     }
 };
-struct jsongetvalStringNumeric : jsongetvalStringNumericBase {
-    PLUGINCHILD("S", "ii", true)
-};
-struct jsongetvalStringNumericK : jsongetvalStringNumericBase {
-    PLUGINCHILDK("S", "ik", true)
-};
 
 
 /*
- Get numeric value by numeric index
+ Get numeric value by JSON Pointer from a file, streaming through the file
  */
-struct jsongetvalNumericNumericBase : plugin<1, 2> {
-    void run() {
-        jsoncons::json selected = jsonSession->data[(int) inargs[1]];
-        outargs[0] = selected.as<MYFLT>();
+struct jsonloadvalNumeric : plugin<1, 2> {
+    PLUGINIT("i", "SS", false)
+    void irun() {
+        outargs[0] = readFileValue(inargs.str_data(0).data, inargs.str_data(1).data).as<MYFLT>();
     }
 };
-struct jsongetvalNumericNumeric : jsongetvalNumericNumericBase {
-    PLUGINCHILD("i", "ii", true)
-};
-struct jsongetvalNumericNumericK : jsongetvalNumericNumericBase {
-    PLUGINCHILDK("k", "ik", true)
+
+
+/*
+ Get numeric array value by JSON Pointer from a file, streaming through the file
+ and reading array items directly into the output
+ */
+struct jsonloadvalNumericArray : plugin<1, 2> {
+    PLUGINIT("i[]", "SS", false)
+    void irun() {
+        ARRAYDAT* array = (ARRAYDAT*) outargs(0);
+        csnd::Csound* cs = csound;
+        streamFileValue(inargs.str_data(0).data, inargs.str_data(1).data, [cs, array](jsoncons::json_stream_cursor& cursor) {
+            streamToCSNumericArray(cs, cursor, array);
+        });
+    }
 };
 
 
+/*
+ Get time taken and bytes read when an object was loaded from file
+ */
+struct jsonloadstats : plugin<2, 1> {
+	PLUGINIT("ii", "i", true)
+	void irun() {
+        outargs[0] = (MYFLT) jsonSession->loadTime;
+        outargs[1] = (MYFLT) jsonSession->loadBytes;
+	}
+};
+
 
 /*
- Get object from an object by key name
+ Open a JSON Lines file for reading with jsonlinesnextk
  */
-struct jsongetString : plugin<1, 2> {
-    PLUGINIT("i", "iS", true)
+struct jsonlinesopen : plugin<1, 1> {
+    PLUGINIT("i", "S", false)
     void irun() {
-        STRINGDAT &input = inargs.str_data(1);
-        jsoncons::json selected = jsonSession->data[std::string(input.data)];
-        JSONSession* jsonSessionOutput;
-        outargs[0] = createHandle<JSONSession>(csound, &jsonSessionOutput, handleName);
-        jsonSessionOutput->active = true;
-        jsonSessionOutput->data = selected;
+        std::shared_ptr<JSONLinesReader> reader = std::make_shared<JSONLinesReader>(inargs.str_data(0).data);
+        JSONLinesSession* linesSession;
+        outargs[0] = createHandle<JSONLinesSession>(csound, &linesSession, linesHandleName);
+        linesSession->reader = reader;
     }
 };
 
 
 /*
- Get object from an array by index
+ Close a JSON Lines file. Opcodes already reading from it may continue to do so
  */
-struct jsongetNumeric : plugin<1, 2> {
-    PLUGINIT("i", "ii", true)
+struct jsonlinesclose : inplug<1> {
+    _PLUGINITBASE("", "i", false)
     void irun() {
-        jsoncons::json selected = jsonSession->data[(int) inargs[1]];
-        JSONSession* jsonSessionOutput;
-        outargs[0] = createHandle<JSONSession>(csound, &jsonSessionOutput, handleName);
-        jsonSessionOutput->active = true;
-        jsonSessionOutput->data = selected;
+        HandleRegistry<JSONLinesSession>* registry = getRegistry<JSONLinesSession>(csound, linesHandleName);
+        if (!registry->destroy(args[0])) {
+            throw std::runtime_error(registry->isStale(args[0]) ? deadHandle : badHandle);
+        }
     }
 };
 
 
 /*
- Query by JSONPath
+ Read a record from a JSON Lines file into an object handle when triggered. The
+ same object handle is used for each record. If no record is available when
+ triggered, it is read as soon as it becomes available
  */
-struct jsonpath : plugin<1, 2> {
-	PLUGINIT("i", "iS", true)
+struct jsonlinesnextk : plugin<3, 4> {
+    PLUGINIT("ikk", "ikJo", false)
+    std::shared_ptr<JSONLinesReader>* reader;
+    MYFLT handle;
+    MYFLT record;
+    bool requested;
+    
+    void initMembers() {
+        reader = nullptr;
+    }
+    
     void irun() {
-        jsoncons::json queried = jsoncons::jsonpath::json_query(
-            jsonSession->data, std::string(inargs.str_data(1).data)
-        );
-        JSONSession* jsonSessionOutput;
-        outargs[0] = createHandle<JSONSession>(csound, &jsonSessionOutput, handleName);
-        jsonSessionOutput->active = true;
-        jsonSessionOutput->data = queried;
+        HandleRegistry<JSONLinesSession>* registry = getRegistry<JSONLinesSession>(csound, linesHandleName);
+        JSONLinesSession* linesSession = registry->get(inargs[0]);
+        if (linesSession == nullptr) {
+            throw std::runtime_error(registry->isStale(inargs[0]) ? deadHandle : badHandle);
+        }
+        sessions = getRegistry<JSONSession>(csound, handleName);
+        handle = outargs[0] = createSession(&jsonSession, inargs[3]);
+        jsonSession->assign(jsoncons::json::null());
+        reader = new std::shared_ptr<JSONLinesReader>(linesSession->reader);
+        requireDeinit();
+        record = -1;
+        requested = false;
+    }
+    
+    int kperf() {
+        try {
+            MYFLT status = JSONLinesReader::waiting;
+            if (inargs[1] != FL(0)) {
+                requested = true;
+                if (inargs[2] >= 0) {
+                    (*reader)->seek((uint64_t) inargs[2]);
+                }
+            }
+            if (requested) {
+                jsoncons::json data;
+                uint64_t index;
+                std::string error;
+                int result = (*reader)->next(data, index, error);
+                if (result == JSONLinesReader::available) {
+                    JSONSession* session = sessions->get(handle);
+                    if (session == nullptr) {
+                        throw std::runtime_error(deadHandle);
+                    }
+                    session->assign(std::move(data));
+                    record = (MYFLT) index;
+                    requested = false;
+                    status = result;
+                } else if (result == JSONLinesReader::invalid) {
+                    csound->message("jsonlinesnextk: skipping record " + std::to_string(index) + ": " + error);
+                } else if (result == JSONLinesReader::finished) {
+                    requested = false;
+                    status = result;
+                }
+            }
+            outargs[1] = status;
+            outargs[2] = record;
+        } catch (const std::exception &ex) {
+            return csound->perf_error(ex.what(), this);
+        }
+        return OK;
+    }
+    
+    int deinit() {
+        delete reader;
+        reader = nullptr;
+        return destroyLocalHandles();
     }
 };
 
 
 /*
- Replace string value by JSONPath
+ Serialise to file
  */
-struct jsonpathrplvalStringBase : inplug<3> {
-	void run() {
-        jsoncons::jsonpath::json_replace(
-            jsonSession->data, 
-            std::string(args.str_data(1).data), 
-            std::string(args.str_data(2).data)
-        );
+struct jsondump : inplug<5> {
+	INPLUGINIT("iSpoo")
+	void irun() {
+        writeJsonFile(jsonSession->read(), args.str_data(1).data, args[2] == FL(1), NumberFormat(args[3], args[4]));
 	}
 };
-struct jsonpathrplvalString : jsonpathrplvalStringBase {
-	INPLUGCHILD("iSS")
-};
-struct jsonpathrplvalStringK : jsonpathrplvalStringBase {
-	INPLUGCHILDK("iSS")
-};
 
 
 /*
- Replace numeric value by JSONPath
+ Serialise to file on a background thread. A snapshot of the object is taken at
+ init time so it may be modified or destroyed while the file is written; the
+ object is copied by the first modification made before the write finishes
  */
-struct jsonpathrplvalNumericBase : inplug<3> {	
-	void run() {
-        jsoncons::jsonpath::json_replace(
-            jsonSession->data, 
-            std::string(args.str_data(1).data), 
-            (float) args[2] // doesn't like double ??
-        );
-	}
-};
-struct jsonpathrplvalNumeric : jsonpathrplvalNumericBase {
-	INPLUGCHILD("iSi")
-};
-struct jsonpathrplvalNumericK : jsonpathrplvalNumericBase {
-	INPLUGCHILDK("iSi")
+struct jsondumpasync : plugin<1, 5> {
+    PLUGINIT("k", "iSpoo", true)
+    AsyncFileWriter* writer;
+    MYFLT status;
+    
+    void initMembers() {
+        writer = nullptr;
+    }
+    
+    void irun() {
+        status = AsyncFileWriter::none;
+        writer = new AsyncFileWriter(getFileWriteQueue(csound));
+        requireDeinit();
+        writer->write(snapshotSession(), inargs.str_data(1).data, inargs[2] == FL(1), NumberFormat(inargs[3], inargs[4]));
+    }
+    
+    int kperf() {
+        if (writer != nullptr) {
+            int result = writer->takeResult();
+            if (result != AsyncFileWriter::none) {
+                status = result;
+                if (result == AsyncFileWriter::failed) {
+                    csound->message("jsondumpasync: " + writer->error);
+                }
+                delete writer;
+                writer = nullptr;
+            }
+        }
+        outargs[0] = status;
+        return OK;
+    }
+    
+    int deinit() {
+        delete writer;
+        writer = nullptr;
+        return destroyLocalHandles();
+    }
 };
 
 
 /*
- Replace element with object by JSONPath
- NOT SUPPORTED
-struct jsonpathrpl : inplug<3> {
-	INPLUGINIT("iSi")
-	void irun() {
-        JSONSession* jsonSession2;
-        getSession(args[2], &jsonSession2);
-        jsoncons::jsonpath::json_replace(
-            jsonSession->data, 
-            std::string(args.str_data(1).data), 
-            jsonSession2->data
-        );
-	}
+ Serialise to file on a background thread whenever triggered. A snapshot of the
+ object is taken when the write starts, as for jsondumpasync. Triggers received while a write is in progress
+ are combined into one write which starts when the current one finishes
+ */
+struct jsondumpk : plugin<2, 6> {
+    PLUGINIT("kk", "iSkpoo", true)
+    AsyncFileWriter* writer;
+    bool deferred;
+    
+    void initMembers() {
+        writer = nullptr;
+    }
+    
+    void irun() {
+        deferred = false;
+        writer = new AsyncFileWriter(getFileWriteQueue(csound));
+        requireDeinit();
+    }
+    
+    int kperf() {
+        try {
+            int result = writer->takeResult();
+            if (result == AsyncFileWriter::failed) {
+                csound->message("jsondumpk: " + writer->error);
+            }
+            if (inargs[2] != FL(0)) {
+                deferred = true;
+            }
+            if (deferred && !writer->isBusy()) {
+                checkSession();
+                writer->write(snapshotSession(), inargs.str_data(1).data, inargs[3] == FL(1), NumberFormat(inargs[4], inargs[5]));
+                deferred = false;
+            }
+            outargs[0] = (MYFLT) result;
+            outargs[1] = (MYFLT) ((writer->isBusy() ? 1 : 0) + (deferred ? 1 : 0));
+        } catch (const std::exception &ex) {
+            return csound->perf_error(ex.what(), this);
+        }
+        return OK;
+    }
+    
+    int deinit() {
+        delete writer;
+        writer = nullptr;
+        return destroyLocalHandles();
+    }
 };
-*/
+
+
+/*
+ Get CBOR encoding options from opcode arguments
+ */
+jsoncons::cbor::cbor_options cborOptions(MYFLT packStrings, MYFLT typedArrays) {
+    jsoncons::cbor::cbor_options options;
+    options.pack_strings(packStrings == FL(1));
+    options.use_typed_arrays(typedArrays >= FL(1));
+    return options;
+}
+
+
+/*
+ Emit encoding events for a document, writing arrays consisting only of doubles
+ as typed arrays in double or single precision. Objects and arrays are emitted
+ without a length, as the CBOR encoder does not count typed arrays as items of
+ containers with a known length
+ */
+void visitWithTypedArrays(const jsoncons::json& value, jsoncons::json_visitor& visitor, bool single) {
+    if (value.is_object()) {
+        visitor.begin_object();
+        for (const auto& member : value.object_range()) {
+            visitor.key(member.key());
+            visitWithTypedArrays(member.value(), visitor, single);
+        }
+        visitor.end_object();
+    } else if (value.is_array()) {
+        bool numeric = !value.empty();
+        for (const jsoncons::json& item : value.array_range()) {
+            if (!item.is_double()) {
+                numeric = false;
+                break;
+            }
+        }
+        if (!numeric) {
+            visitor.begin_array();
+            for (const jsoncons::json& item : value.array_range()) {
+                visitWithTypedArrays(item, visitor, single);
+            }
+            visitor.end_array();
+        } else if (single) {
+            std::vector<float> items;
+            items.reserve(value.size());
+            for (const jsoncons::json& item : value.array_range()) {
+                items.push_back((float) item.as_double());
+            }
+            visitor.typed_array(jsoncons::span<const float>(items.data(), items.size()));
+        } else {
+            std::vector<double> items;
+            items.reserve(value.size());
+            for (const jsoncons::json& item : value.array_range()) {
+                items.push_back(item.as_double());
+            }
+            visitor.typed_array(jsoncons::span<const double>(items.data(), items.size()));
+        }
+    } else if (value.is_null()) {
+        visitor.null_value(value.tag());
+    } else if (value.is_bool()) {
+        visitor.bool_value(value.as_bool(), value.tag());
+    } else if (value.is_int64()) {
+        visitor.int64_value(value.as<int64_t>(), value.tag());
+    } else if (value.is_uint64()) {
+        visitor.uint64_value(value.as<uint64_t>(), value.tag());
+    } else if (value.is_string()) {
+        visitor.string_value(value.as_string_view(), value.tag());
+    } else if (value.is_byte_string()) {
+        visitor.byte_string_value(value.as_byte_string_view(), value.tag());
+    } else {
+        visitor.double_value(value.as_double(), value.tag());
+    }
+}
+
+
+/*
+ Encode a document to CBOR. If typedArrays is 1 or 2, arrays of doubles are
+ written as RFC 8746 typed arrays in double or single precision respectively
+ */
+void encodeCbor(const jsoncons::json& data, jsoncons::json_visitor& encoder, MYFLT typedArrays) {
+    if (typedArrays >= FL(1)) {
+        visitWithTypedArrays(data, encoder, typedArrays == FL(2));
+        encoder.flush();
+    } else {
+        data.dump(encoder);
+    }
+}
+
 
 /*
- Query by JSON Pointer
+ Encode a numeric Csound array to CBOR as a single typed array
  */
-struct jsonptr : plugin<1, 2> {
-	PLUGINIT("i", "iS", true)
-    void irun() {
-        jsoncons::json queried = jsoncons::jsonpointer::get(
-            jsonSession->data, std::string(inargs.str_data(1).data)
-        );
-        JSONSession* jsonSessionOutput;
-        outargs[0] = createHandle<JSONSession>(csound, &jsonSessionOutput, handleName);
-        jsonSessionOutput->active = true;
-        jsonSessionOutput->data = queried;
+std::vector<uint8_t> csNumericArrayToCbor(ARRAYDAT* array, bool single) {
+    std::vector<uint8_t> bytes;
+    jsoncons::cbor::cbor_options options;
+    options.use_typed_arrays(true);
+    jsoncons::cbor::cbor_bytes_encoder encoder(bytes, options);
+    std::size_t size = (std::size_t) array->sizes[0];
+    if (single && sizeof(MYFLT) != sizeof(float)) {
+        std::vector<float> items(array->data, array->data + size);
+        encoder.typed_array(jsoncons::span<const float>(items.data(), size));
+    } else {
+        encoder.typed_array(jsoncons::span<const MYFLT>(array->data, size));
     }
-};
+    encoder.flush();
+    return bytes;
+}
 
 
 /*
- Get string value by JSON Pointer
+ Decoding target which reads a CBOR typed array or array of numbers into a
+ numeric Csound array. Typed arrays are copied directly to the output
  */
-struct jsonptrvalStringBase : plugin<1, 2> {
-    void run() {
-        STRINGDAT &output = outargs.str_data(0);
-        jsoncons::json queried = jsoncons::jsonpointer::get(
-            jsonSession->data, std::string(inargs.str_data(1).data)
-        );
-        std::string value = queried.as<std::string>();
-        output.size = value.size();
-        output.data = csound->strdup((char*) value.c_str());
+class CborNumericArrayReader : public jsoncons::json_visitor {
+public:
+    bool invalid;
+    
+    CborNumericArrayReader(csnd::Csound* csound, ARRAYDAT* array) : invalid(false), csound(csound), array(array), depth(0) {}
+    
+private:
+    template <typename T>
+    bool readTypedArray(const jsoncons::span<const T>& data, std::error_code& ec) {
+        if (depth != 0) return reject(ec);
+        arrayInit(csound, array, data.size(), 1);
+        if (std::is_same<T, MYFLT>::value) {
+            memcpy(array->data, data.data(), data.size() * sizeof(MYFLT));
+        } else {
+            std::copy(data.begin(), data.end(), array->data);
+        }
+        return false;
     }
-};
-struct jsonptrvalString : jsonptrvalStringBase {
-	PLUGINCHILD("S", "iS", true)
-};
-struct jsonptrvalStringK : jsonptrvalStringBase {
-	PLUGINCHILDK("S", "iS", true)
+    
+    bool readNumber(double value, std::error_code& ec) {
+        if (depth != 1) return reject(ec);
+        values.push_back((MYFLT) value);
+        return true;
+    }
+    
+    bool reject(std::error_code& ec) {
+        invalid = true;
+        ec = jsoncons::conv_errc::not_vector;
+        return false;
+    }
+    
+    void visit_flush() override {}
+    
+    bool visit_typed_array(const jsoncons::span<const double>& data, jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        return readTypedArray(data, ec);
+    }
+    
+    bool visit_typed_array(const jsoncons::span<const float>& data, jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        return readTypedArray(data, ec);
+    }
+    
+    bool visit_begin_array(jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        if (depth++ != 0) return reject(ec);
+        values.clear();
+        return true;
+    }
+    
+    bool visit_end_array(const jsoncons::ser_context&, std::error_code&) override {
+        depth--;
+        arrayInit(csound, array, values.size(), 1);
+        if (!values.empty()) {
+            memcpy(array->data, values.data(), values.size() * sizeof(MYFLT));
+        }
+        return false;
+    }
+    
+    bool visit_double(double value, jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        return readNumber(value, ec);
+    }
+    
+    bool visit_int64(int64_t value, jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        return readNumber((double) value, ec);
+    }
+    
+    bool visit_uint64(uint64_t value, jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        return readNumber((double) value, ec);
+    }
+    
+    bool visit_begin_object(jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        return reject(ec);
+    }
+    
+    bool visit_end_object(const jsoncons::ser_context&, std::error_code& ec) override {
+        return reject(ec);
+    }
+    
+    bool visit_key(const string_view_type&, const jsoncons::ser_context&, std::error_code& ec) override {
+        return reject(ec);
+    }
+    
+    bool visit_null(jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        return reject(ec);
+    }
+    
+    bool visit_bool(bool, jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        return reject(ec);
+    }
+    
+    bool visit_string(const string_view_type&, jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        return reject(ec);
+    }
+    
+    bool visit_byte_string(const jsoncons::byte_string_view&, jsoncons::semantic_tag, const jsoncons::ser_context&, std::error_code& ec) override {
+        return reject(ec);
+    }
+    
+    csnd::Csound* csound;
+    ARRAYDAT* array;
+    int depth;
+    std::vector<MYFLT> values;
 };
 
 
 /*
- Get string array value by JSON Pointer
+ Decode a CBOR typed array or array of numbers to a numeric Csound array
  */
-struct jsonptrvalStringArrayBase : plugin<1, 2> {
-    void run() {
-        jsoncons::json queried = jsoncons::jsonpointer::get(
-            jsonSession->data, std::string(inargs.str_data(1).data)
-        );
-        jsonArrayToCSArray(csound, &queried, (ARRAYDAT*) outargs(0), true);
+void cborToCSNumericArray(csnd::Csound* csound, const std::vector<uint8_t>& bytes, ARRAYDAT* array) {
+    CborNumericArrayReader visitor(csound, array);
+    jsoncons::cbor::cbor_bytes_reader reader(bytes, visitor);
+    std::error_code ec;
+    reader.read(ec);
+    if (visitor.invalid) {
+        throw std::runtime_error(notArray);
+    } else if (ec) {
+        throw jsoncons::ser_error(ec, reader.line(), reader.column());
     }
-};
-struct jsonptrvalStringArray : jsonptrvalStringArrayBase {
-	PLUGINCHILD("S[]", "iS", true)
-};
-struct jsonptrvalStringArrayK : jsonptrvalStringArrayBase {
-	PLUGINCHILDK("S[]", "iS", true)
-};
+}
 
 
 /*
- Get numeric value by JSON Pointer
+ Load from CBOR file, decoding directly from the mapped file contents
  */
-struct jsonptrvalNumericBase : plugin<1, 2> {
-    void run() {
-        jsoncons::json queried = jsoncons::jsonpointer::get(
-            jsonSession->data, std::string(inargs.str_data(1).data)
+struct jsonloadcbor : plugin<1, 2> {
+	PLUGINIT("i", "So", false)
+	void irun() {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        MappedFile file(inargs.str_data(0).data);
+        jsoncons::json decoded = jsoncons::cbor::decode_cbor<jsoncons::json>(
+            jsoncons::byte_string_view((const uint8_t*) file.data(), file.size())
         );
-        outargs[0] = queried.as<MYFLT>();
-    }
-};
-struct jsonptrvalNumeric : jsonptrvalNumericBase {
-	PLUGINCHILD("i", "iS", true)
-};
-struct jsonptrvalNumericK : jsonptrvalNumericBase {
-	PLUGINCHILDK("k", "iS", true)
+        outargs[0] = createSession(&jsonSession, inargs[1]);
+        jsonSession->assign(std::move(decoded));
+        jsonSession->loadBytes = file.size();
+        jsonSession->loadTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+	}
 };
 
 
 /*
- Get numeric array value by JSON Pointer
+ Serialise to CBOR file
  */
-struct jsonptrvalNumericArrayBase : plugin<1, 2> {
-    void run() {
-        jsoncons::json queried = jsoncons::jsonpointer::get(
-            jsonSession->data, std::string(inargs.str_data(1).data)
-        );
-        jsonArrayToCSArray(csound, &queried, (ARRAYDAT*) outargs(0), false);
-    }
-};
-struct jsonptrvalNumericArray : jsonptrvalNumericArrayBase {
-	PLUGINCHILD("i[]", "iS", true)
-};
-struct jsonptrvalNumericArrayK : jsonptrvalNumericArrayBase {
-	PLUGINCHILDK("k[]", "iS", true)
+struct jsondumpcbor : inplug<4> {
+	INPLUGINIT("iSoo")
+	void irun() {
+        const jsoncons::json& data = jsonSession->read();
+        jsoncons::cbor::cbor_options options = cborOptions(args[2], args[3]);
+        MYFLT typedArrays = args[3];
+        writeFile(args.str_data(1).data, std::ios::binary, [&data, &options, typedArrays](std::ofstream& fileStream) {
+            jsoncons::cbor::cbor_stream_encoder encoder(fileStream, options);
+            encodeCbor(data, encoder, typedArrays);
+        });
+	}
 };
 
 
 /*
- Get numeric array value by JSON Pointer
+ Load from CBOR provided as a hexadecimal string
  */
-struct jsonptrarr : plugin<1, 2> {
-    PLUGINIT("i[]", "iS", true)
-    void irun() {
-        JSONSession* jsonSession2;
-        jsoncons::json queried = jsoncons::jsonpointer::get(
-            jsonSession->data, std::string(inargs.str_data(1).data)
-        );
-        std::vector<jsoncons::json> vals = queried.as<std::vector<jsoncons::json>>();
-        ARRAYDAT* array = (ARRAYDAT*) outargs(0);
-        arrayInit(csound, array, vals.size(), 1);
-        MYFLT handle;
-        for (std::size_t index = 0; index < vals.size(); index++) {
-            handle = createHandle<JSONSession>(csound, &jsonSession2, handleName);
-            jsonSession2->active = true;
-            jsonSession2->data = vals[index];
-            array->data[index] = handle;
-        }
-    }
+struct jsonloadscborString : plugin<1, 2> {
+	PLUGINIT("i", "So", false)
+	void irun() {
+        jsoncons::json decoded = jsoncons::cbor::decode_cbor<jsoncons::json>(hexStringToBytes(inargs.str_data(0)));
+        outargs[0] = createSession(&jsonSession, inargs[1]);
+        jsonSession->assign(std::move(decoded));
+	}
 };
 
 
 /*
- Check for existence by JSON Pointer
+ Load from CBOR provided as an array of bytes
  */
-struct jsonptrhasBase : plugin<1, 2> {
-    void run() {
-        outargs[0] = (int) jsoncons::jsonpointer::contains(
-            jsonSession->data, std::string(inargs.str_data(1).data)
-        );
-    }
-};
-struct jsonptrhas : jsonptrhasBase {
-	PLUGINCHILD("i", "iS", true)
-};
-struct jsonptrhasK : jsonptrhasBase {
-	PLUGINCHILDK("k", "iS", true)
+struct jsonloadscborArray : plugin<1, 2> {
+	PLUGINIT("i", "i[]o", false)
+	void irun() {
+        jsoncons::json decoded = jsoncons::cbor::decode_cbor<jsoncons::json>(csArrayToBytes((ARRAYDAT*) inargs(0)));
+        outargs[0] = createSession(&jsonSession, inargs[1]);
+        jsonSession->assign(std::move(decoded));
+	}
 };
 
 
 /*
- Add string value by JSON Pointer
+ Serialise to CBOR as a hexadecimal string
  */
-struct jsonptraddvalStringBase : inplug<3> {
+struct jsondumpscborStringBase : plugin<1, 3> {
 	void run() {
-        jsoncons::jsonpointer::add(
-            jsonSession->data, 
-            std::string(args.str_data(1).data), 
-            std::string(args.str_data(2).data),
-            true // create if not exists
-        );
+        std::vector<uint8_t> bytes;
+        jsoncons::cbor::cbor_bytes_encoder encoder(bytes, cborOptions(inargs[1], inargs[2]));
+        encodeCbor(jsonSession->read(), encoder, inargs[2]);
+        outputHexString(csound, &outargs.str_data(0), bytes);
 	}
 };
-struct jsonptraddvalString : jsonptraddvalStringBase {
-    INPLUGCHILD("iSS")
+struct jsondumpscborString : jsondumpscborStringBase {
+	PLUGINCHILD("S", "ioo", true)
 };
-struct jsonptraddvalStringK : jsonptraddvalStringBase {
-    INPLUGCHILDK("iSS")
+struct jsondumpscborStringK : jsondumpscborStringBase {
+	PLUGINCHILDK("S", "ioo", true)
 };
 
 
 /*
- Add numeric value by JSON Pointer
+ Serialise to CBOR as an array of bytes
  */
-struct jsonptraddvalNumericBase : inplug<3> {
+struct jsondumpscborArrayBase : plugin<1, 3> {
 	void run() {
-        jsoncons::jsonpointer::add(
-            jsonSession->data, 
-            std::string(args.str_data(1).data), 
-            args[2],
-            true // create if not exists
-        );
+        std::vector<uint8_t> bytes;
+        jsoncons::cbor::cbor_bytes_encoder encoder(bytes, cborOptions(inargs[1], inargs[2]));
+        encodeCbor(jsonSession->read(), encoder, inargs[2]);
+        bytesToCSArray(csound, bytes, (ARRAYDAT*) outargs(0));
 	}
 };
-struct jsonptraddvalNumeric : jsonptraddvalNumericBase {
-	INPLUGCHILD("iSi")
+struct jsondumpscborArray : jsondumpscborArrayBase {
+	PLUGINCHILD("i[]", "ioo", true)
 };
-struct jsonptraddvalNumericK : jsonptraddvalNumericBase {
-	INPLUGCHILDK("iSk")
+struct jsondumpscborArrayK : jsondumpscborArrayBase {
+	PLUGINCHILDK("k[]", "ioo", true)
 };
 
 
 /*
- Add object by JSON Pointer
+ Encode a numeric array to CBOR as a typed array in a hexadecimal string
  */
-struct jsonptradd : inplug<3> {
-	INPLUGINIT("iSi")
-	void irun() {
-        JSONSession* jsonSession2;
-        getSession(args[2], &jsonSession2);
-        
-        jsoncons::jsonpointer::add(
-            jsonSession->data, 
-            std::string(args.str_data(1).data), 
-            jsonSession2->data,
-            true // create if not exists
-        );
+struct jsondumpscborNumericArrayStringBase : plugin<1, 2> {
+	void run() {
+        outputHexString(csound, &outargs.str_data(0), csNumericArrayToCbor((ARRAYDAT*) inargs(0), inargs[1] == FL(1)));
 	}
 };
+struct jsondumpscborNumericArrayString : jsondumpscborNumericArrayStringBase {
+	PLUGINCHILD("S", "i[]o", false)
+};
+struct jsondumpscborNumericArrayStringK : jsondumpscborNumericArrayStringBase {
+	PLUGINCHILDK("S", "k[]o", false)
+};
 
 
 /*
- Remove by JSON Pointer
+ Encode a numeric array to CBOR as a typed array in an array of bytes
  */
-struct jsonptrrmBase : inplug<2> {
+struct jsondumpscborNumericArrayArrayBase : plugin<1, 2> {
 	void run() {
-        char* query = args.str_data(1).data;
-        jsoncons::jsonpointer::remove(jsonSession->data, std::string(query));
+        bytesToCSArray(csound, csNumericArrayToCbor((ARRAYDAT*) inargs(0), inargs[1] == FL(1)), (ARRAYDAT*) outargs(0));
 	}
 };
-struct jsonptrrm : jsonptrrmBase {
-	INPLUGCHILD("iS")
+struct jsondumpscborNumericArrayArray : jsondumpscborNumericArrayArrayBase {
+	PLUGINCHILD("i[]", "i[]o", false)
 };
-struct jsonptrrmK : jsonptrrmBase {
-	INPLUGCHILDK("iS")
+struct jsondumpscborNumericArrayArrayK : jsondumpscborNumericArrayArrayBase {
+	PLUGINCHILDK("k[]", "k[]o", false)
 };
 
 
 /*
- Replace string value by JSON Pointer
+ Decode a CBOR typed array or array of numbers in a hexadecimal string to a numeric array
  */
-struct jsonptrrplvalStringBase : inplug<3> {
+struct jsonloadscborNumericArrayStringBase : plugin<1, 1> {
 	void run() {
-        jsoncons::jsonpointer::replace(
-            jsonSession->data, 
-            std::string(args.str_data(1).data), 
-            std::string(args.str_data(2).data), 
-            true // create if missing
-        );
+        cborToCSNumericArray(csound, hexStringToBytes(inargs.str_data(0)), (ARRAYDAT*) outargs(0));
 	}
 };
-struct jsonptrrplvalString : jsonptrrplvalStringBase {
-	INPLUGCHILD("iSS")
+struct jsonloadscborNumericArrayString : jsonloadscborNumericArrayStringBase {
+	PLUGINCHILD("i[]", "S", false)
 };
-struct jsonptrrplvalStringK : jsonptrrplvalStringBase {
-	INPLUGCHILDK("iSS")
+struct jsonloadscborNumericArrayStringK : jsonloadscborNumericArrayStringBase {
+	PLUGINCHILDK("k[]", "S", false)
 };
 
 
 /*
- Replace numeric value by JSON Pointer
+ Decode a CBOR typed array or array of numbers in an array of bytes to a numeric array
  */
-struct jsonptrrplvalNumericBase : inplug<3> {
+struct jsonloadscborNumericArrayArrayBase : plugin<1, 1> {
 	void run() {
-        jsoncons::jsonpointer::replace(
-            jsonSession->data, 
-            std::string(args.str_data(1).data), 
-            args[2],
-            true // create if missing
-        );
+        cborToCSNumericArray(csound, csArrayToBytes((ARRAYDAT*) inargs(0)), (ARRAYDAT*) outargs(0));
 	}
 };
-struct jsonptrrplvalNumeric : jsonptrrplvalNumericBase {
-	INPLUGCHILD("iSi")
+struct jsonloadscborNumericArrayArray : jsonloadscborNumericArrayArrayBase {
+	PLUGINCHILD("i[]", "i[]", false)
 };
-struct jsonptrrplvalNumericK : jsonptrrplvalNumericBase {
-	INPLUGCHILDK("iSk")
+struct jsonloadscborNumericArrayArrayK : jsonloadscborNumericArrayArrayBase {
+	PLUGINCHILDK("k[]", "k[]", false)
 };
 
 
 /*
- Replace object by JSON Pointer
+ Load from MessagePack file, decoding directly from the mapped file contents
  */
-struct jsonptrrpl : csnd::InPlug<3> {
-    INPLUGSESSION
-	INPLUGINIT("iSi")
+struct jsonloadmsgpack : plugin<1, 2> {
+	PLUGINIT("i", "So", false)
 	void irun() {
-        JSONSession* jsonSession2;
-        getSession(args[2], &jsonSession2);
-        
-        jsoncons::jsonpointer::replace(
-            jsonSession->data, 
-            std::string(args.str_data(1).data), 
-            jsonSession2->data,
-            true // create if missing
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        MappedFile file(inargs.str_data(0).data);
+        jsoncons::json decoded = jsoncons::msgpack::decode_msgpack<jsoncons::json>(
+            jsoncons::byte_string_view((const uint8_t*) file.data(), file.size())
         );
+        outargs[0] = createSession(&jsonSession, inargs[1]);
+        jsonSession->assign(std::move(decoded));
+        jsonSession->loadBytes = file.size();
+        jsonSession->loadTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count();
 	}
 };
 
 
 /*
- Get numeric array from object
+ Serialise to MessagePack file
  */
-struct jsonarrvalNumericBase : plugin<1, 1> {
-    void run() {
-        jsonArrayToCSArray(csound, &(jsonSession->data), (ARRAYDAT*) outargs(0), false);         
-    }
-};
-struct jsonarrvalNumeric : jsonarrvalNumericBase {
-	PLUGINCHILD("i[]", "i", true)
-};
-struct jsonarrvalNumericK : jsonarrvalNumericBase {
-	PLUGINCHILDK("k[]", "i", true)
+struct jsondumpmsgpack : inplug<2> {
+	INPLUGINIT("iS")
+	void irun() {
+        const jsoncons::json& data = jsonSession->read();
+        writeFile(args.str_data(1).data, std::ios::binary, [&data](std::ofstream& fileStream) {
+            jsoncons::msgpack::encode_msgpack(data, fileStream);
+        });
+	}
 };
 
 
 /*
- Get string array from object
+ Load from MessagePack provided as a hexadecimal string
  */
-struct jsonarrvalStringBase : plugin<1, 1> {
-    void run() {
-        jsonArrayToCSArray(csound, &(jsonSession->data), (ARRAYDAT*) outargs(0), true);         
-    }
-};
-struct jsonarrvalString : jsonarrvalStringBase {
-	PLUGINCHILD("S[]", "i", true)
-};
-struct jsonarrvalStringK : jsonarrvalStringBase {
-	PLUGINCHILDK("S[]", "i", true)
+struct jsonloadsmsgpackString : plugin<1, 2> {
+	PLUGINIT("i", "So", false)
+	void irun() {
+        jsoncons::json decoded = jsoncons::msgpack::decode_msgpack<jsoncons::json>(hexStringToBytes(inargs.str_data(0)));
+        outargs[0] = createSession(&jsonSession, inargs[1]);
+        jsonSession->assign(std::move(decoded));
+	}
 };
 
 
 /*
- Get array of object handles from object
+ Load from MessagePack provided as an array of bytes
  */
-struct jsonarr : plugin<1, 1> {
-    PLUGINIT("i[]", "i", true)
-    void irun() {
-        JSONSession* jsonSession2;
-        std::vector<jsoncons::json> vals = 
-                jsonSession->data.as<std::vector<jsoncons::json>>();
-        ARRAYDAT* array = (ARRAYDAT*) outargs(0);
-        arrayInit(csound, array, vals.size(), 1);
-        MYFLT handle;
-        for (std::size_t index = 0; index < vals.size(); index++) {
-            handle = createHandle<JSONSession>(csound, &jsonSession2, handleName);
-            jsonSession2->active = true;
-            jsonSession2->data = vals[index];
-            array->data[index] = handle;
-        }
-    }
+struct jsonloadsmsgpackArray : plugin<1, 2> {
+	PLUGINIT("i", "i[]o", false)
+	void irun() {
+        jsoncons::json decoded = jsoncons::msgpack::decode_msgpack<jsoncons::json>(csArrayToBytes((ARRAYDAT*) inargs(0)));
+        outargs[0] = createSession(&jsonSession, inargs[1]);
+        jsonSession->assign(std::move(decoded));
+	}
 };
 
 
 /*
- Dump to string
+ Serialise to MessagePack as a hexadecimal string
  */
-struct jsondumpsBase : plugin<1, 2> {
+struct jsondumpsmsgpackStringBase : plugin<1, 1> {
 	void run() {
-        STRINGDAT &output = outargs.str_data(0);
-        std::ostringstream stream;
-        if (inargs[1] == FL(1)) {
-            stream << jsoncons::pretty_print(jsonSession->data);
-        } else {
-            stream << jsonSession->data;
-        }
-        char* text = csound->strdup((char*) stream.str().c_str());
-        output.size = strlen(text);
-        output.data = text;
+        std::vector<uint8_t> bytes;
+        jsoncons::msgpack::encode_msgpack(jsonSession->read(), bytes);
+        outputHexString(csound, &outargs.str_data(0), bytes);
 	}
 };
-struct jsondumps : jsondumpsBase {
-	PLUGINCHILD("S", "ip", true)
-};
-struct jsondumpsK : jsondumpsBase {
-	PLUGINCHILDK("S", "ip", true)
+struct jsondumpsmsgpackString : jsondumpsmsgpackStringBase {
+	PLUGINCHILD("S", "i", true)
 };
-
-
-/*
- Destroy object and clear memory
- */
-struct jsondestroy : inplug<1> {
-    INPLUGINIT("i")
-    void irun() {
-        jsonSession->data.~basic_json();
-        jsonSession->active = false;
-    }
+struct jsondumpsmsgpackStringK : jsondumpsmsgpackStringBase {
+	PLUGINCHILDK("S", "i", true)
 };
 
 
 /*
- Load from file
+ Serialise to MessagePack as an array of bytes
  */
-struct jsonload : plugin<1, 1> {
-	PLUGINIT("i", "S", false)
-	void irun() {
-        std::ifstream fileStream(inargs.str_data(0).data);
-        jsoncons::json parsed = jsoncons::json::parse(fileStream);
-        outargs[0] = createHandle<JSONSession>(csound, &jsonSession, handleName);
-        jsonSession->active = true;
-        jsonSession->data = parsed;
+struct jsondumpsmsgpackArrayBase : plugin<1, 1> {
+	void run() {
+        std::vector<uint8_t> bytes;
+        jsoncons::msgpack::encode_msgpack(jsonSession->read(), bytes);
+        bytesToCSArray(csound, bytes, (ARRAYDAT*) outargs(0));
 	}
 };
-
-
-/*
- Serialise to file
- */
-struct jsondump : inplug<3> {
-	INPLUGINIT("iSp")
-	void irun() {
-        std::ofstream fileStream;
-        fileStream.open(args.str_data(1).data, std::ios::in | std::ios::trunc);
-        if (!fileStream.is_open()) {
-            throw std::runtime_error("could not open file for writing");
-        }
-        if (args[2] == FL(1)) {
-            fileStream << jsoncons::pretty_print(jsonSession->data);
-        } else {
-            fileStream << jsonSession->data;
-        }
-        fileStream.close();
-	}
+struct jsondumpsmsgpackArray : jsondumpsmsgpackArrayBase {
+	PLUGINCHILD("i[]", "i", true)
+};
+struct jsondumpsmsgpackArrayK : jsondumpsmsgpackArrayBase {
+	PLUGINCHILDK("k[]", "i", true)
 };
 
 
@@ -1146,11 +4017,52 @@ struct jsondump : inplug<3> {
 void csnd::on_load(csnd::Csound *csound) {
     csnd::plugin<jsoninit>(csound, "jsoninit", csnd::thread::i);
     csnd::plugin<jsonloads>(csound, "jsonloads", csnd::thread::i);
+    csnd::plugin<jsonloadsinc>(csound, "jsonloadsinc", csnd::thread::ik);
     csnd::plugin<jsondumps>(csound, "jsondumps", csnd::thread::i);
     csnd::plugin<jsondestroy>(csound, "jsondestroy", csnd::thread::i);
+    csnd::plugin<jsonpromote>(csound, "jsonpromote", csnd::thread::i);
     csnd::plugin<jsondumpsK>(csound, "jsondumpsk", csnd::thread::ik);
     csnd::plugin<jsonload>(csound, "jsonload", csnd::thread::i);
+    csnd::plugin<jsonloadproj>(csound, "jsonloadproj", csnd::thread::i);
+    csnd::plugin<jsonloadcsv>(csound, "jsonloadcsv", csnd::thread::i);
+    csnd::plugin<jsonloadcsvcolsNumeric>(csound, "jsonloadcsvcols.i", csnd::thread::i);
+    csnd::plugin<jsonloadcsvcolsString>(csound, "jsonloadcsvcols.S", csnd::thread::i);
+    csnd::plugin<jsonloadstats>(csound, "jsonloadstats", csnd::thread::i);
+    csnd::plugin<jsonloadvalString>(csound, "jsonloadval.S", csnd::thread::i);
+    csnd::plugin<jsonloadvalStringArray>(csound, "jsonloadval.Sa", csnd::thread::i);
+    csnd::plugin<jsonloadvalNumeric>(csound, "jsonloadval.i", csnd::thread::i);
+    csnd::plugin<jsonloadvalNumericArray>(csound, "jsonloadval.ia", csnd::thread::i);
+    csnd::plugin<jsonloadasync>(csound, "jsonloadasync", csnd::thread::ik);
+    csnd::plugin<jsonlinesopen>(csound, "jsonlinesopen", csnd::thread::i);
+    csnd::plugin<jsonlinesclose>(csound, "jsonlinesclose", csnd::thread::i);
+    csnd::plugin<jsonlinesnextk>(csound, "jsonlinesnextk", csnd::thread::ik);
     csnd::plugin<jsondump>(csound, "jsondump", csnd::thread::i);
+    csnd::plugin<jsondumpasync>(csound, "jsondumpasync", csnd::thread::ik);
+    csnd::plugin<jsondumpk>(csound, "jsondumpk", csnd::thread::ik);
+    csnd::plugin<jsonloadcbor>(csound, "jsonloadcbor", csnd::thread::i);
+    csnd::plugin<jsondumpcbor>(csound, "jsondumpcbor", csnd::thread::i);
+    csnd::plugin<jsonloadscborString>(csound, "jsonloadscbor.S", csnd::thread::i);
+    csnd::plugin<jsonloadscborArray>(csound, "jsonloadscbor.a", csnd::thread::i);
+    csnd::plugin<jsondumpscborString>(csound, "jsondumpscbor.S", csnd::thread::i);
+    csnd::plugin<jsondumpscborStringK>(csound, "jsondumpscbork.S", csnd::thread::ik);
+    csnd::plugin<jsondumpscborArray>(csound, "jsondumpscbor.a", csnd::thread::i);
+    csnd::plugin<jsondumpscborArrayK>(csound, "jsondumpscbork.a", csnd::thread::ik);
+    csnd::plugin<jsondumpscborNumericArrayString>(csound, "jsondumpscbor.iaS", csnd::thread::i);
+    csnd::plugin<jsondumpscborNumericArrayStringK>(csound, "jsondumpscbork.kaS", csnd::thread::ik);
+    csnd::plugin<jsondumpscborNumericArrayArray>(csound, "jsondumpscbor.iaa", csnd::thread::i);
+    csnd::plugin<jsondumpscborNumericArrayArrayK>(csound, "jsondumpscbork.kaa", csnd::thread::ik);
+    csnd::plugin<jsonloadscborNumericArrayString>(csound, "jsonloadscbor.Sia", csnd::thread::i);
+    csnd::plugin<jsonloadscborNumericArrayStringK>(csound, "jsonloadscbork.Ska", csnd::thread::ik);
+    csnd::plugin<jsonloadscborNumericArrayArray>(csound, "jsonloadscbor.aia", csnd::thread::i);
+    csnd::plugin<jsonloadscborNumericArrayArrayK>(csound, "jsonloadscbork.aka", csnd::thread::ik);
+    csnd::plugin<jsonloadmsgpack>(csound, "jsonloadmsgpack", csnd::thread::i);
+    csnd::plugin<jsondumpmsgpack>(csound, "jsondumpmsgpack", csnd::thread::i);
+    csnd::plugin<jsonloadsmsgpackString>(csound, "jsonloadsmsgpack.S", csnd::thread::i);
+    csnd::plugin<jsonloadsmsgpackArray>(csound, "jsonloadsmsgpack.a", csnd::thread::i);
+    csnd::plugin<jsondumpsmsgpackString>(csound, "jsondumpsmsgpack.S", csnd::thread::i);
+    csnd::plugin<jsondumpsmsgpackStringK>(csound, "jsondumpsmsgpackk.S", csnd::thread::ik);
+    csnd::plugin<jsondumpsmsgpackArray>(csound, "jsondumpsmsgpack.a", csnd::thread::i);
+    csnd::plugin<jsondumpsmsgpackArrayK>(csound, "jsondumpsmsgpackk.a", csnd::thread::ik);
     csnd::plugin<jsonmerge>(csound, "jsonmerge", csnd::thread::i);
     csnd::plugin<jsontype>(csound, "jsontype", csnd::thread::i);
     csnd::plugin<jsontypeString>(csound, "jsontype.S", csnd::thread::i);
@@ -1191,6 +4103,7 @@ void csnd::on_load(csnd::Csound *csound) {
     csnd::plugin<jsonpathrplvalStringK>(csound, "jsonpathrplvalk.S", csnd::thread::ik);
     csnd::plugin<jsonpathrplvalNumeric>(csound, "jsonpathrplval.i", csnd::thread::i);
     csnd::plugin<jsonpathrplvalNumericK>(csound, "jsonpathrplvalk.i", csnd::thread::ik);
+    csnd::plugin<jsonpathstats>(csound, "jsonpathstats", csnd::thread::i);
 //    csnd::plugin<jsonpathrpl>(csound, "jsonpathrpl", csnd::thread::i);
     
     csnd::plugin<jsonptr>(csound, "jsonptr", csnd::thread::i);
@@ -1198,13 +4111,13 @@ void csnd::on_load(csnd::Csound *csound) {
     csnd::plugin<jsonptrarr>(csound, "jsonptrarr", csnd::thread::i);
     
     csnd::plugin<jsonptrvalStringArray>(csound, "jsonptrval.Sa", csnd::thread::i);
-    csnd::plugin<jsonptrvalStringArrayK>(csound, "jsonptrval.Sak", csnd::thread::i);
+    csnd::plugin<jsonptrvalStringArrayK>(csound, "jsonptrvalk.Sa", csnd::thread::ik);
     csnd::plugin<jsonptrvalString>(csound, "jsonptrval.S", csnd::thread::i);
-    csnd::plugin<jsonptrvalStringK>(csound, "jsonptrval.Sk", csnd::thread::i);
+    csnd::plugin<jsonptrvalStringK>(csound, "jsonptrvalk.S", csnd::thread::ik);
     csnd::plugin<jsonptrvalNumeric>(csound, "jsonptrval.i", csnd::thread::i);
-    csnd::plugin<jsonptrvalNumericK>(csound, "jsonptrval.k", csnd::thread::i);
+    csnd::plugin<jsonptrvalNumericK>(csound, "jsonptrvalk.k", csnd::thread::ik);
     csnd::plugin<jsonptrvalNumericArray>(csound, "jsonptrval.ia", csnd::thread::i);
-    csnd::plugin<jsonptrvalNumericArrayK>(csound, "jsonptrval.ka", csnd::thread::i);
+    csnd::plugin<jsonptrvalNumericArrayK>(csound, "jsonptrvalk.ka", csnd::thread::ik);
     
     csnd::plugin<jsonptrhas>(csound, "jsonptrhas", csnd::thread::i);
     csnd::plugin<jsonptrhasK>(csound, "jsonptrhask", csnd::thread::ik);